@@ -0,0 +1,109 @@
+/**
+ * @file    allocator.h - Pluggable memory allocator interface
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#pragma once
+
+#include <stdlib.h>
+#include <stddef.h>
+
+/**
+ * Alignment guaranteed by every bundled allocator
+ */
+#define ALLOCATOR_ALIGNMENT _Alignof(max_align_t)
+
+/**
+ * Rounds size up to a multiple of ALLOCATOR_ALIGNMENT
+ */
+#define ALLOCATOR_ALIGN(size) (((size) + ALLOCATOR_ALIGNMENT - 1) & ~(ALLOCATOR_ALIGNMENT - 1))
+
+/**
+ * Memory allocator used by the data structures for their storage
+ */
+typedef struct allocator {
+
+    /**
+     * Allocates size bytes
+     *
+     * @param context of the allocator
+     * @param size number of bytes
+     * @return pointer to the memory, NULL on failure
+     */
+    void* (*alloc)(void* context, size_t size);
+
+    /**
+     * Resizes a block, keeping its content. A NULL ptr behaves like alloc
+     *
+     * @param context of the allocator
+     * @param ptr block to resize
+     * @param old_size current size of the block
+     * @param new_size requested size
+     * @return pointer to the resized block, NULL on failure (ptr stays valid)
+     */
+    void* (*realloc)(void* context, void* ptr, size_t old_size, size_t new_size);
+
+    /**
+     * Releases a block. A NULL ptr is ignored
+     *
+     * @param context of the allocator
+     * @param ptr block to release
+     * @param size size of the block
+     */
+    void (*free)(void* context, void* ptr, size_t size);
+
+    /**
+     * State of the allocator, passed to every function
+     */
+    void* context;
+
+} allocator;
+
+/**
+ * Allocates through malloc
+ */
+void* heap_alloc(void* context, size_t size)
+{
+    (void) context;
+    return malloc(size);
+}
+
+/**
+ * Resizes through realloc
+ */
+void* heap_realloc(void* context, void* ptr, size_t old_size, size_t new_size)
+{
+    (void) context;
+    (void) old_size;
+    return realloc(ptr, new_size);
+}
+
+/**
+ * Releases through free
+ */
+void heap_free(void* context, void* ptr, size_t size)
+{
+    (void) context;
+    (void) size;
+    free(ptr);
+}
+
+/**
+ * Returns the allocator backed by malloc, realloc and free
+ *
+ * @return heap allocator
+ */
+allocator heap_allocator()
+{
+    allocator a = { heap_alloc, heap_realloc, heap_free, NULL };
+    return a;
+}
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file    allocator_test.c - Main program for testing vectors on arena and pool allocators
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "../Vector/vector.h"
+#include "./arena.h"
+#include "./pool.h"
+
+/**
+ * Pushes count integers and checks they can be read back
+ */
+int fill_and_check(vector* v, int count)
+{
+    int status = SUCCESS;
+    int i;
+    for (i = 0; i < count; ++i)
+    {
+        status |= v -> push_back(v, &i);
+    }
+    for (i = 0; i < count; ++i)
+    {
+        status |= (*(int*) v -> at(v, i) != i);
+    }
+    return status;
+}
+
+int main()
+{
+    int status;
+
+    // Request-scoped vectors released all together with the arena
+    arena request;
+    arena_init(&request, 0);
+    allocator from_arena = arena_allocator(&request);
+
+    vector a;
+    vector b;
+    vector_init_packed_allocator(&a, sizeof(int), 0, 0, &from_arena);
+    vector_init_allocator(&b, sizeof(int), 0, 0, &from_arena);
+
+    status = fill_and_check(&a, 10000);
+    printf("Arena packed vector:    (status %d)\n", status);
+    status = fill_and_check(&b, 1000);
+    printf("Arena slot vector:      (status %d)\n", status);
+    printf("Reallocations:               %5d\n", a.get_reallocations(&a));
+    printf("Arena free:             (status %d)\n", arena_free(&request));
+
+    // Short-lived vectors recycling blocks through the pool
+    pool blocks;
+    pool_init(&blocks);
+    allocator from_pool = pool_allocator(&blocks);
+
+    int round;
+    status = SUCCESS;
+    for (round = 0; round < 100; ++round)
+    {
+        vector v;
+        vector_init_packed_allocator(&v, sizeof(int), 0, 0, &from_pool);
+        status |= fill_and_check(&v, 100 * (round % 10 + 1));
+        v.free(&v);
+    }
+    printf("Pool vectors:           (status %d)\n", status);
+
+    vector big;
+    vector_init_packed_allocator(&big, sizeof(double), 0, 0, &from_pool);
+    status = big.reserve(&big, 100000);
+    printf("Pool large block:       (status %d)\n", status);
+    printf("Pool free:              (status %d)\n", pool_free(&blocks));
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file    arena.h - Bump allocator releasing all of its memory at once
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#pragma once
+
+#include "./allocator.h"
+#include "../utils.h"
+
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * Block of memory the arena carves allocations from
+ */
+typedef struct arena_chunk {
+
+    /**
+     * Previously filled chunk
+     */
+    struct arena_chunk* previous;
+
+    /**
+     * Usable bytes after the header
+     */
+    size_t capacity;
+
+    /**
+     * Bytes already handed out
+     */
+    size_t used;
+
+} arena_chunk;
+
+/**
+ * Bump allocator: allocations only move a cursor forward, single blocks are
+ * never returned to the system and everything is released by arena_free
+ */
+typedef struct arena {
+
+    /**
+     * Chunk allocations are currently carved from
+     */
+    arena_chunk* current;
+
+    /**
+     * Minimum size of a new chunk
+     */
+    size_t chunk_size;
+
+    /**
+     * Last block handed out, the only one that can grow or shrink in place
+     */
+    void* last;
+
+} arena;
+
+/**
+ * Returns the first usable byte of a chunk
+ */
+unsigned char* arena_chunk_data(arena_chunk* chunk)
+{
+    return (unsigned char*) chunk + ALLOCATOR_ALIGN(sizeof(arena_chunk));
+}
+
+/**
+ * Initializes an empty arena
+ *
+ * @param a pointer to the arena
+ * @param chunk_size minimum size of the chunks requested to the system
+ * @return status
+ */
+int arena_init(arena* a, size_t chunk_size)
+{
+    int status = FAILURE;
+    if (a)
+    {
+        a -> current = NULL;
+        a -> chunk_size = chunk_size > 0 ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+        a -> last = NULL;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Allocates size bytes from the arena
+ *
+ * @param context pointer to the arena
+ * @param size number of bytes
+ * @return pointer to the memory, NULL on failure
+ */
+void* arena_alloc(void* context, size_t size)
+{
+    arena* a = context;
+    void* ptr = NULL;
+    if (a)
+    {
+        size = ALLOCATOR_ALIGN(size);
+        arena_chunk* chunk = a -> current;
+        if (!chunk || chunk -> capacity - chunk -> used < size)
+        {
+            size_t capacity = max(a -> chunk_size, size);
+            chunk = malloc(ALLOCATOR_ALIGN(sizeof(arena_chunk)) + capacity);
+            if (!chunk)
+            {
+                return ptr;
+            }
+            chunk -> previous = a -> current;
+            chunk -> capacity = capacity;
+            chunk -> used = 0;
+            a -> current = chunk;
+        }
+        ptr = arena_chunk_data(chunk) + chunk -> used;
+        chunk -> used += size;
+        a -> last = ptr;
+    }
+    return ptr;
+}
+
+/**
+ * Resizes a block. The last block handed out is resized in place when the
+ * current chunk has room, any other block is copied into a new one
+ *
+ * @param context pointer to the arena
+ * @param ptr block to resize
+ * @param old_size current size of the block
+ * @param new_size requested size
+ * @return pointer to the resized block, NULL on failure
+ */
+void* arena_realloc(void* context, void* ptr, size_t old_size, size_t new_size)
+{
+    arena* a = context;
+    if (!a || !ptr)
+    {
+        return arena_alloc(context, new_size);
+    }
+
+    arena_chunk* chunk = a -> current;
+    if (ptr == a -> last)
+    {
+        size_t offset = (unsigned char*) ptr - arena_chunk_data(chunk);
+        if (ALLOCATOR_ALIGN(new_size) <= chunk -> capacity - offset)
+        {
+            chunk -> used = offset + ALLOCATOR_ALIGN(new_size);
+            return ptr;
+        }
+    }
+    else if (new_size <= old_size)
+    {
+        return ptr;
+    }
+
+    void* moved = arena_alloc(context, new_size);
+    if (moved)
+    {
+        copy(moved, ptr, min(old_size, new_size));
+    }
+    return moved;
+}
+
+/**
+ * Releases a block. Only the last block handed out gives its memory back
+ *
+ * @param context pointer to the arena
+ * @param ptr block to release
+ * @param size size of the block
+ */
+void arena_release(void* context, void* ptr, size_t size)
+{
+    arena* a = context;
+    (void) size;
+    if (a && ptr && ptr == a -> last)
+    {
+        a -> current -> used = (unsigned char*) ptr - arena_chunk_data(a -> current);
+        a -> last = NULL;
+    }
+}
+
+/**
+ * Returns an allocator drawing from the arena
+ *
+ * @param a pointer to the arena
+ * @return allocator
+ */
+allocator arena_allocator(arena* a)
+{
+    allocator alloc = { arena_alloc, arena_realloc, arena_release, a };
+    return alloc;
+}
+
+/**
+ * Releases every block handed out by the arena at once
+ *
+ * @param a pointer to the arena
+ * @return status
+ */
+int arena_free(arena* a)
+{
+    int status = FAILURE;
+    if (a)
+    {
+        while (a -> current)
+        {
+            arena_chunk* previous = a -> current -> previous;
+            free(a -> current);
+            a -> current = previous;
+        }
+        a -> last = NULL;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,292 @@
+/**
+ * @file    pool.h - Size-class pool allocator
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#pragma once
+
+#include "./allocator.h"
+#include "../utils.h"
+
+#define POOL_MIN_BLOCK 16
+#define POOL_CLASSES 9
+#define POOL_MAX_BLOCK (POOL_MIN_BLOCK << (POOL_CLASSES - 1))
+#define POOL_SLAB_SIZE (64 * 1024)
+
+/**
+ * Header of a memory area requested to the system: either a slab holding
+ * blocks of one size class or a single block bigger than POOL_MAX_BLOCK
+ */
+typedef struct pool_area {
+
+    /**
+     * Previous area of the same list
+     */
+    struct pool_area* previous;
+
+    /**
+     * Next area of the same list
+     */
+    struct pool_area* next;
+
+} pool_area;
+
+/**
+ * Released block waiting to be reused
+ */
+typedef struct pool_block {
+
+    /**
+     * Next released block of the same size class
+     */
+    struct pool_block* next;
+
+} pool_block;
+
+/**
+ * Pool allocator: blocks are rounded up to a power of two size class and
+ * recycled through one free list per class. Blocks bigger than
+ * POOL_MAX_BLOCK are requested to the system one by one. Everything is
+ * released by pool_free
+ */
+typedef struct pool {
+
+    /**
+     * Released blocks of every size class
+     */
+    pool_block* free_lists[POOL_CLASSES];
+
+    /**
+     * Slabs blocks are carved from
+     */
+    pool_area* slabs;
+
+    /**
+     * Blocks bigger than POOL_MAX_BLOCK
+     */
+    pool_area* large;
+
+    /**
+     * Bytes of the newest slab not handed out yet
+     */
+    size_t slab_left;
+
+} pool;
+
+/**
+ * Returns the size class of a block of size bytes, or VALUE_ERROR when the
+ * block is bigger than POOL_MAX_BLOCK
+ */
+int pool_class(size_t size)
+{
+    int size_class = 0;
+    size_t block = POOL_MIN_BLOCK;
+    while (block < size && size_class < POOL_CLASSES)
+    {
+        block <<= 1;
+        size_class++;
+    }
+    return size_class < POOL_CLASSES ? size_class : VALUE_ERROR;
+}
+
+/**
+ * Initializes an empty pool
+ *
+ * @param p pointer to the pool
+ * @return status
+ */
+int pool_init(pool* p)
+{
+    int status = FAILURE;
+    if (p)
+    {
+        int i;
+        for (i = 0; i < POOL_CLASSES; ++i)
+        {
+            p -> free_lists[i] = NULL;
+        }
+        p -> slabs = NULL;
+        p -> large = NULL;
+        p -> slab_left = 0;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Allocates size bytes from the pool
+ *
+ * @param context pointer to the pool
+ * @param size number of bytes
+ * @return pointer to the memory, NULL on failure
+ */
+void* pool_alloc(void* context, size_t size)
+{
+    pool* p = context;
+    if (!p)
+    {
+        return NULL;
+    }
+
+    size_t header = ALLOCATOR_ALIGN(sizeof(pool_area));
+    int size_class = pool_class(size);
+    if (size_class == VALUE_ERROR)
+    {
+        pool_area* area = malloc(header + size);
+        if (!area)
+        {
+            return NULL;
+        }
+        area -> previous = NULL;
+        area -> next = p -> large;
+        if (p -> large)
+        {
+            p -> large -> previous = area;
+        }
+        p -> large = area;
+        return (unsigned char*) area + header;
+    }
+
+    pool_block* block = p -> free_lists[size_class];
+    if (block)
+    {
+        p -> free_lists[size_class] = block -> next;
+        return block;
+    }
+
+    size_t block_size = (size_t) POOL_MIN_BLOCK << size_class;
+    if (p -> slab_left < block_size)
+    {
+        pool_area* slab = malloc(header + POOL_SLAB_SIZE);
+        if (!slab)
+        {
+            return NULL;
+        }
+        slab -> previous = NULL;
+        slab -> next = p -> slabs;
+        p -> slabs = slab;
+        p -> slab_left = POOL_SLAB_SIZE;
+    }
+    p -> slab_left -= block_size;
+    return (unsigned char*) p -> slabs + header + p -> slab_left;
+}
+
+/**
+ * Releases a block, putting it back into its size class
+ *
+ * @param context pointer to the pool
+ * @param ptr block to release
+ * @param size size of the block
+ */
+void pool_release(void* context, void* ptr, size_t size)
+{
+    pool* p = context;
+    if (!p || !ptr)
+    {
+        return;
+    }
+
+    int size_class = pool_class(size);
+    if (size_class == VALUE_ERROR)
+    {
+        pool_area* area = (pool_area*) ((unsigned char*) ptr - ALLOCATOR_ALIGN(sizeof(pool_area)));
+        if (area -> previous)
+        {
+            area -> previous -> next = area -> next;
+        }
+        else
+        {
+            p -> large = area -> next;
+        }
+        if (area -> next)
+        {
+            area -> next -> previous = area -> previous;
+        }
+        free(area);
+        return;
+    }
+
+    pool_block* block = ptr;
+    block -> next = p -> free_lists[size_class];
+    p -> free_lists[size_class] = block;
+}
+
+/**
+ * Resizes a block. Blocks staying in the same size class are kept as they are
+ *
+ * @param context pointer to the pool
+ * @param ptr block to resize
+ * @param old_size current size of the block
+ * @param new_size requested size
+ * @return pointer to the resized block, NULL on failure
+ */
+void* pool_realloc(void* context, void* ptr, size_t old_size, size_t new_size)
+{
+    if (!ptr)
+    {
+        return pool_alloc(context, new_size);
+    }
+
+    int old_class = pool_class(old_size);
+    if (old_class != VALUE_ERROR && old_class == pool_class(new_size))
+    {
+        return ptr;
+    }
+
+    void* moved = pool_alloc(context, new_size);
+    if (moved)
+    {
+        copy(moved, ptr, min(old_size, new_size));
+        pool_release(context, ptr, old_size);
+    }
+    return moved;
+}
+
+/**
+ * Returns an allocator drawing from the pool
+ *
+ * @param p pointer to the pool
+ * @return allocator
+ */
+allocator pool_allocator(pool* p)
+{
+    allocator alloc = { pool_alloc, pool_realloc, pool_release, p };
+    return alloc;
+}
+
+/**
+ * Releases every block handed out by the pool at once
+ *
+ * @param p pointer to the pool
+ * @return status
+ */
+int pool_free(pool* p)
+{
+    int status = FAILURE;
+    if (p)
+    {
+        pool_area* lists[] = { p -> slabs, p -> large };
+        int i;
+        for (i = 0; i < 2; ++i)
+        {
+            pool_area* area = lists[i];
+            while (area)
+            {
+                pool_area* next = area -> next;
+                free(area);
+                area = next;
+            }
+        }
+        status = pool_init(p);
+    }
+    return status;
+}
+
+#endif
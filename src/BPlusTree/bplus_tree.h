@@ -0,0 +1,1181 @@
+/**
+ * @file    bplus_tree.h - B+-tree of fixed-size keys with range scans
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#pragma once
+
+#include "../Vector/vector.h"
+
+/**
+ * Target size of a node in Bytes, a page by default. Nodes of big keys are
+ * made bigger so that they hold at least BPLUS_TREE_MIN_CAPACITY keys
+ */
+#ifndef BPLUS_TREE_NODE_BYTES
+#define BPLUS_TREE_NODE_BYTES 4096
+#endif
+
+#define BPLUS_TREE_MIN_CAPACITY 4
+
+/**
+ * Deepest tree supported. Every inner node has at least two children, so
+ * this is more than enough for INT_MAX keys
+ */
+#define BPLUS_TREE_MAX_HEIGHT 48
+
+/**
+ * Node of the tree. Leaves hold the keys followed by their values and are
+ * linked to their neighbours, inner nodes hold count separators followed
+ * by count + 1 children: child i holds the keys before separator i, child
+ * i + 1 the keys from separator i on. Keys and values are stored after
+ * the header, aligned as if allocated
+ */
+typedef struct bplus_node {
+
+    /**
+     * Whether the node is a leaf
+     */
+    int leaf;
+
+    /**
+     * Number of keys
+     */
+    int count;
+
+    /**
+     * Previous leaf, NULL for inner nodes and the first leaf
+     */
+    struct bplus_node* prev;
+
+    /**
+     * Next leaf, NULL for inner nodes and the last leaf
+     */
+    struct bplus_node* next;
+
+} bplus_node;
+
+/**
+ * Ordered map of fixed-size keys to fixed-size values. Nodes are as big as
+ * a page and keys are searched with binary searches inside them, range
+ * scans walk the linked leaves like an array
+ */
+typedef struct bplus_tree {
+
+    /**
+     * Root node, NULL when nothing was ever inserted
+     */
+    bplus_node* root;
+
+    /**
+     * Leftmost leaf
+     */
+    bplus_node* first;
+
+    /**
+     * Rightmost leaf
+     */
+    bplus_node* last;
+
+    /**
+     * Number of keys
+     */
+    int size;
+
+    /**
+     * Number of levels, 1 when the root is a leaf
+     */
+    int height;
+
+    /**
+     * Size of a key in Bytes
+     */
+    int key_size;
+
+    /**
+     * Size of a value in Bytes, may be 0
+     */
+    int value_size;
+
+    /**
+     * Maximum number of keys of a leaf
+     */
+    int leaf_capacity;
+
+    /**
+     * Maximum number of separators of an inner node
+     */
+    int inner_capacity;
+
+    /**
+     * Size of a leaf in Bytes
+     */
+    size_t leaf_bytes;
+
+    /**
+     * Size of an inner node in Bytes
+     */
+    size_t inner_bytes;
+
+    /**
+     * Offset of the values from the keys in a leaf
+     */
+    size_t value_offset;
+
+    /**
+     * Offset of the children from the keys in an inner node
+     */
+    size_t child_offset;
+
+    /**
+     * Room for the separators and children of an overfull inner node while
+     * it is split, followed by the separator carried to the parent
+     */
+    unsigned char* scratch;
+
+    /**
+     * Size of scratch in Bytes
+     */
+    size_t scratch_bytes;
+
+    /**
+     * Order of the keys
+     */
+    comparator cmp;
+
+    /**
+     * Allocator of the nodes
+     */
+    allocator allocator;
+
+} bplus_tree;
+
+/**
+ * Position in the tree, used to scan ranges forward and backward
+ */
+typedef struct bplus_cursor {
+
+    /**
+     * Tree being scanned
+     */
+    bplus_tree* tree;
+
+    /**
+     * Current leaf, NULL past either end
+     */
+    bplus_node* leaf;
+
+    /**
+     * Index of the current key in the leaf
+     */
+    int index;
+
+} bplus_cursor;
+
+/**
+ * Returns the keys of a node
+ */
+unsigned char* bplus_keys(bplus_node* n)
+{
+    return (unsigned char*) n + ALLOCATOR_ALIGN(sizeof(bplus_node));
+}
+
+/**
+ * Returns the i-th key of a node
+ */
+unsigned char* bplus_key(bplus_tree* t, bplus_node* n, int i)
+{
+    return bplus_keys(n) + (size_t) i * t -> key_size;
+}
+
+/**
+ * Returns the i-th value of a leaf
+ */
+unsigned char* bplus_value(bplus_tree* t, bplus_node* n, int i)
+{
+    return bplus_keys(n) + t -> value_offset + (size_t) i * t -> value_size;
+}
+
+/**
+ * Returns the children of an inner node
+ */
+bplus_node** bplus_children(bplus_tree* t, bplus_node* n)
+{
+    return (bplus_node**) (bplus_keys(n) + t -> child_offset);
+}
+
+/**
+ * Returns the index of the first key of a node not before key
+ */
+int bplus_lower_bound(bplus_tree* t, bplus_node* n, const void* key)
+{
+    return (int) lower_bound(bplus_keys(n), n -> count, t -> key_size, key, t -> cmp);
+}
+
+/**
+ * Returns the index of the child of an inner node which may hold key
+ */
+int bplus_child_index(bplus_tree* t, bplus_node* n, const void* key)
+{
+    return (int) upper_bound(bplus_keys(n), n -> count, t -> key_size, key, t -> cmp);
+}
+
+/**
+ * Allocates an empty node
+ */
+bplus_node* bplus_new_node(bplus_tree* t, int leaf)
+{
+    size_t bytes = leaf ? t -> leaf_bytes : t -> inner_bytes;
+    bplus_node* n = t -> allocator.alloc(t -> allocator.context, bytes);
+    if (n)
+    {
+        n -> leaf = leaf;
+        n -> count = 0;
+        n -> prev = NULL;
+        n -> next = NULL;
+    }
+    return n;
+}
+
+/**
+ * Releases a node
+ */
+void bplus_free_node(bplus_tree* t, bplus_node* n)
+{
+    t -> allocator.free(t -> allocator.context, n, n -> leaf ? t -> leaf_bytes : t -> inner_bytes);
+}
+
+/**
+ * Moves count entries of a leaf, with their values, from index from to
+ * index to of leaf dst
+ */
+void bplus_move_entries(bplus_tree* t, bplus_node* dst, int to, bplus_node* src, int from, int count)
+{
+    move(bplus_key(t, dst, to), bplus_key(t, src, from), (size_t) count * t -> key_size);
+    if (t -> value_size > 0)
+    {
+        move(bplus_value(t, dst, to), bplus_value(t, src, from), (size_t) count * t -> value_size);
+    }
+}
+
+/**
+ * Moves count separators of an inner node from index from to index to of
+ * node dst
+ */
+void bplus_move_separators(bplus_tree* t, bplus_node* dst, int to, bplus_node* src, int from, int count)
+{
+    move(bplus_key(t, dst, to), bplus_key(t, src, from), (size_t) count * t -> key_size);
+}
+
+/**
+ * Moves count children of an inner node from index from to index to of
+ * node dst
+ */
+void bplus_move_children(bplus_tree* t, bplus_node* dst, int to, bplus_node* src, int from, int count)
+{
+    move(bplus_children(t, dst) + to, bplus_children(t, src) + from, (size_t) count * sizeof(bplus_node*));
+}
+
+/**
+ * Initializes an empty tree drawing its nodes from the given allocator
+ *
+ * @param t pointer to the tree
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes, 0 for a set of keys
+ * @param cmp order of the keys
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int bplus_tree_init_allocator(bplus_tree* t, int key_size, int value_size, comparator cmp, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!t || key_size <= 0 || value_size < 0 || !cmp)
+    {
+        return status;
+    }
+
+    size_t header = ALLOCATOR_ALIGN(sizeof(bplus_node));
+    size_t room = BPLUS_TREE_NODE_BYTES - header;
+
+    // As many entries as fit, keeping the values and children aligned
+    int capacity = (int) (room / (key_size + value_size));
+    while (capacity > BPLUS_TREE_MIN_CAPACITY &&
+           ALLOCATOR_ALIGN((size_t) capacity * key_size) + (size_t) capacity * value_size > room)
+    {
+        capacity--;
+    }
+    t -> leaf_capacity = max(capacity, BPLUS_TREE_MIN_CAPACITY);
+    t -> value_offset = ALLOCATOR_ALIGN((size_t) t -> leaf_capacity * key_size);
+    t -> leaf_bytes = max(header + t -> value_offset + (size_t) t -> leaf_capacity * value_size,
+                          (size_t) BPLUS_TREE_NODE_BYTES);
+
+    capacity = (int) (room / (key_size + sizeof(bplus_node*)));
+    while (capacity > BPLUS_TREE_MIN_CAPACITY &&
+           ALLOCATOR_ALIGN((size_t) capacity * key_size) + (size_t) (capacity + 1) * sizeof(bplus_node*) > room)
+    {
+        capacity--;
+    }
+    t -> inner_capacity = max(capacity, BPLUS_TREE_MIN_CAPACITY);
+    t -> child_offset = ALLOCATOR_ALIGN((size_t) t -> inner_capacity * key_size);
+    t -> inner_bytes = max(header + t -> child_offset + (size_t) (t -> inner_capacity + 1) * sizeof(bplus_node*),
+                           (size_t) BPLUS_TREE_NODE_BYTES);
+
+    t -> allocator = alloc ? *alloc : heap_allocator();
+
+    // An inner node with one more separator and child, then the carried key
+    t -> scratch_bytes = ALLOCATOR_ALIGN((size_t) (t -> inner_capacity + 1) * key_size) +
+                         ALLOCATOR_ALIGN((size_t) (t -> inner_capacity + 2) * sizeof(bplus_node*)) +
+                         (size_t) key_size;
+    t -> scratch = t -> allocator.alloc(t -> allocator.context, t -> scratch_bytes);
+    if (!t -> scratch)
+    {
+        return status;
+    }
+
+    t -> root = NULL;
+    t -> first = NULL;
+    t -> last = NULL;
+    t -> size = 0;
+    t -> height = 0;
+    t -> key_size = key_size;
+    t -> value_size = value_size;
+    t -> cmp = cmp;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes an empty tree on the heap
+ *
+ * @param t pointer to the tree
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes, 0 for a set of keys
+ * @param cmp order of the keys
+ * @return status
+ */
+int bplus_tree_init(bplus_tree* t, int key_size, int value_size, comparator cmp)
+{
+    return bplus_tree_init_allocator(t, key_size, value_size, cmp, NULL);
+}
+
+/**
+ * Returns the number of keys
+ */
+int bplus_tree_size(bplus_tree* t)
+{
+    return t ? t -> size : VALUE_ERROR;
+}
+
+/**
+ * Returns the number of levels, 0 for a tree never filled
+ */
+int bplus_tree_height(bplus_tree* t)
+{
+    return t ? t -> height : VALUE_ERROR;
+}
+
+/**
+ * Descends to the leaf which may hold key
+ */
+bplus_node* bplus_find_leaf(bplus_tree* t, const void* key)
+{
+    bplus_node* n = t -> root;
+    while (n && !n -> leaf)
+    {
+        n = bplus_children(t, n)[bplus_child_index(t, n, key)];
+    }
+    return n;
+}
+
+/**
+ * Looks for a key
+ *
+ * @param t pointer to the tree
+ * @param key to look for
+ * @return pointer to its value (to the key when values are empty), NULL if
+ *         missing
+ */
+void* bplus_tree_find(bplus_tree* t, const void* key)
+{
+    if (!t || !key)
+    {
+        return NULL;
+    }
+    bplus_node* leaf = bplus_find_leaf(t, key);
+    if (!leaf)
+    {
+        return NULL;
+    }
+    int i = bplus_lower_bound(t, leaf, key);
+    if (i == leaf -> count || t -> cmp(bplus_key(t, leaf, i), key) != 0)
+    {
+        return NULL;
+    }
+    return t -> value_size > 0 ? bplus_value(t, leaf, i) : bplus_key(t, leaf, i);
+}
+
+/**
+ * Checks whether a key is in the tree
+ */
+int bplus_tree_contains(bplus_tree* t, const void* key)
+{
+    return bplus_tree_find(t, key) != NULL;
+}
+
+/**
+ * Returns the separator carried to the parent by the last inner split
+ */
+unsigned char* bplus_carried(bplus_tree* t)
+{
+    return t -> scratch + ALLOCATOR_ALIGN((size_t) (t -> inner_capacity + 1) * t -> key_size) +
+           ALLOCATOR_ALIGN((size_t) (t -> inner_capacity + 2) * sizeof(bplus_node*));
+}
+
+/**
+ * Inserts a separator and the child after it at position slot of an inner
+ * node, splitting the node when it is full. On a split the separator to
+ * insert in the parent is copied in the scratch and spare becomes the new
+ * right node
+ *
+ * @param spare empty inner node, used only when n is full
+ * @return new right node, the node itself if it did not split
+ */
+bplus_node* bplus_insert_inner(bplus_tree* t, bplus_node* n, int slot, const void* key, bplus_node* child,
+                               bplus_node* spare)
+{
+    bplus_node** children = bplus_children(t, n);
+    if (n -> count < t -> inner_capacity)
+    {
+        bplus_move_separators(t, n, slot + 1, n, slot, n -> count - slot);
+        bplus_move_children(t, n, slot + 2, n, slot + 1, n -> count - slot);
+        copy(bplus_key(t, n, slot), key, t -> key_size);
+        children[slot + 1] = child;
+        n -> count++;
+        return n;
+    }
+
+    bplus_node* right = spare;
+
+    // Lay the overfull node out in the scratch, then split it around the middle
+    int ks = t -> key_size;
+    int total = n -> count + 1;
+    unsigned char* keys = t -> scratch;
+    bplus_node** all = (bplus_node**) (t -> scratch + ALLOCATOR_ALIGN((size_t) (t -> inner_capacity + 1) * ks));
+    copy(keys, bplus_keys(n), (size_t) slot * ks);
+    copy(keys + (size_t) slot * ks, key, ks);
+    copy(keys + (size_t) (slot + 1) * ks, bplus_key(t, n, slot), (size_t) (n -> count - slot) * ks);
+    copy(all, children, (size_t) (slot + 1) * sizeof(bplus_node*));
+    all[slot + 1] = child;
+    copy(all + slot + 2, children + slot + 1, (size_t) (n -> count - slot) * sizeof(bplus_node*));
+
+    int middle = total / 2;
+    copy(bplus_keys(n), keys, (size_t) middle * ks);
+    copy(children, all, (size_t) (middle + 1) * sizeof(bplus_node*));
+    n -> count = middle;
+    copy(bplus_keys(right), keys + (size_t) (middle + 1) * ks, (size_t) (total - middle - 1) * ks);
+    copy(bplus_children(t, right), all + middle + 1, (size_t) (total - middle) * sizeof(bplus_node*));
+    right -> count = total - middle - 1;
+    copy(bplus_carried(t), keys + (size_t) middle * ks, ks);
+    return right;
+}
+
+/**
+ * Allocates every node the split of the full leaf at the end of path needs:
+ * the new leaf, a node for each full ancestor the split reaches and a new
+ * root when it reaches the root. Either all of them are allocated or none
+ *
+ * @param path inner nodes from the root to the parent of the leaf
+ * @param depth number of nodes in path
+ * @param spare receiving the new leaf followed by the inner nodes
+ * @return number of inner nodes, VALUE_ERROR when out of memory
+ */
+int bplus_reserve_split(bplus_tree* t, bplus_node** path, int depth, bplus_node** spare)
+{
+    int inner = 0;
+    int d = depth - 1;
+    while (d >= 0 && path[d] -> count == t -> inner_capacity)
+    {
+        inner++;
+        d--;
+    }
+    if (d < 0)
+    {
+        inner++;
+    }
+
+    int i;
+    for (i = 0; i <= inner; ++i)
+    {
+        spare[i] = bplus_new_node(t, i == 0);
+        if (!spare[i])
+        {
+            while (i > 0)
+            {
+                bplus_free_node(t, spare[--i]);
+            }
+            return VALUE_ERROR;
+        }
+    }
+    return inner;
+}
+
+/**
+ * Adds a key with its value, or replaces the value of a key already there.
+ * A full leaf is split in two halves and the split goes up as far as needed.
+ * The nodes of the split are allocated before the tree is touched, so on
+ * failure the tree is left as it was
+ *
+ * @param t pointer to the tree
+ * @param key to add
+ * @param value of the key, may be NULL when values are empty
+ * @return status
+ */
+int bplus_tree_insert(bplus_tree* t, const void* key, const void* value)
+{
+    int status = FAILURE;
+    if (!t || !key || (!value && t -> value_size > 0) || t -> size == INT_MAX)
+    {
+        return status;
+    }
+    if (!t -> root)
+    {
+        t -> root = bplus_new_node(t, true);
+        if (!t -> root)
+        {
+            return status;
+        }
+        t -> first = t -> root;
+        t -> last = t -> root;
+        t -> height = 1;
+    }
+
+    bplus_node* path[BPLUS_TREE_MAX_HEIGHT];
+    int slots[BPLUS_TREE_MAX_HEIGHT];
+    int depth = 0;
+    bplus_node* leaf = t -> root;
+    while (!leaf -> leaf)
+    {
+        path[depth] = leaf;
+        slots[depth] = bplus_child_index(t, leaf, key);
+        leaf = bplus_children(t, leaf)[slots[depth]];
+        depth++;
+    }
+
+    int i = bplus_lower_bound(t, leaf, key);
+    if (i < leaf -> count && t -> cmp(bplus_key(t, leaf, i), key) == 0)
+    {
+        if (t -> value_size > 0)
+        {
+            copy(bplus_value(t, leaf, i), value, t -> value_size);
+        }
+        status = SUCCESS;
+        return status;
+    }
+
+    bplus_node* spare[BPLUS_TREE_MAX_HEIGHT + 2];
+    int inner = 0;
+    int next = 1;
+    bplus_node* target = leaf;
+    bplus_node* right = NULL;
+    if (leaf -> count == t -> leaf_capacity)
+    {
+        inner = bplus_reserve_split(t, path, depth, spare);
+        if (inner == VALUE_ERROR)
+        {
+            return status;
+        }
+        right = spare[0];
+        // Both halves end up with (capacity + 1) / 2 keys or one more
+        int left_count = (t -> leaf_capacity + 1) / 2;
+        int from = i < left_count ? left_count - 1 : left_count;
+        bplus_move_entries(t, right, 0, leaf, from, leaf -> count - from);
+        right -> count = leaf -> count - from;
+        leaf -> count = from;
+        if (i >= left_count)
+        {
+            target = right;
+            i -= left_count;
+        }
+        right -> next = leaf -> next;
+        right -> prev = leaf;
+        if (leaf -> next)
+        {
+            leaf -> next -> prev = right;
+        }
+        else
+        {
+            t -> last = right;
+        }
+        leaf -> next = right;
+    }
+
+    bplus_move_entries(t, target, i + 1, target, i, target -> count - i);
+    copy(bplus_key(t, target, i), key, t -> key_size);
+    if (t -> value_size > 0)
+    {
+        copy(bplus_value(t, target, i), value, t -> value_size);
+    }
+    target -> count++;
+    t -> size++;
+
+    // Carry the split up: the first key of the new leaf separates it
+    const void* separator = right ? bplus_key(t, right, 0) : NULL;
+    bplus_node* left = leaf;
+    while (right)
+    {
+        if (depth == 0)
+        {
+            bplus_node* root = spare[next++];
+            copy(bplus_keys(root), separator, t -> key_size);
+            bplus_children(t, root)[0] = left;
+            bplus_children(t, root)[1] = right;
+            root -> count = 1;
+            t -> root = root;
+            t -> height++;
+            break;
+        }
+        depth--;
+        bplus_node* parent = path[depth];
+        bplus_node* split = bplus_insert_inner(t, parent, slots[depth], separator, right,
+                                              next <= inner ? spare[next] : NULL);
+        next += split != parent;
+        right = split == parent ? NULL : split;
+        separator = bplus_carried(t);
+        left = parent;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Fixes a leaf which fell below half of its capacity, at position slot of
+ * its parent, borrowing a key from a sibling or merging with it
+ *
+ * @return whether the parent lost a child
+ */
+int bplus_rebalance_leaf(bplus_tree* t, bplus_node* parent, int slot)
+{
+    bplus_node** children = bplus_children(t, parent);
+    bplus_node* leaf = children[slot];
+    bplus_node* left = slot > 0 ? children[slot - 1] : NULL;
+    bplus_node* right = slot < parent -> count ? children[slot + 1] : NULL;
+    int minimum = t -> leaf_capacity / 2;
+
+    if (left && left -> count > minimum)
+    {
+        bplus_move_entries(t, leaf, 1, leaf, 0, leaf -> count);
+        bplus_move_entries(t, leaf, 0, left, left -> count - 1, 1);
+        left -> count--;
+        leaf -> count++;
+        copy(bplus_key(t, parent, slot - 1), bplus_key(t, leaf, 0), t -> key_size);
+        return false;
+    }
+    if (right && right -> count > minimum)
+    {
+        bplus_move_entries(t, leaf, leaf -> count, right, 0, 1);
+        bplus_move_entries(t, right, 0, right, 1, right -> count - 1);
+        right -> count--;
+        leaf -> count++;
+        copy(bplus_key(t, parent, slot), bplus_key(t, right, 0), t -> key_size);
+        return false;
+    }
+
+    // Merge the right one of the pair into the left one
+    if (!left)
+    {
+        left = leaf;
+        leaf = right;
+        slot++;
+    }
+    bplus_move_entries(t, left, left -> count, leaf, 0, leaf -> count);
+    left -> count += leaf -> count;
+    left -> next = leaf -> next;
+    if (leaf -> next)
+    {
+        leaf -> next -> prev = left;
+    }
+    else
+    {
+        t -> last = left;
+    }
+    bplus_free_node(t, leaf);
+    bplus_move_separators(t, parent, slot - 1, parent, slot, parent -> count - slot);
+    bplus_move_children(t, parent, slot, parent, slot + 1, parent -> count - slot);
+    parent -> count--;
+    return true;
+}
+
+/**
+ * Fixes an inner node which fell below half of its capacity, at position
+ * slot of its parent, rotating a child through the parent from a sibling
+ * or merging with it around their separator
+ *
+ * @return whether the parent lost a child
+ */
+int bplus_rebalance_inner(bplus_tree* t, bplus_node* parent, int slot)
+{
+    bplus_node** children = bplus_children(t, parent);
+    bplus_node* node = children[slot];
+    bplus_node* left = slot > 0 ? children[slot - 1] : NULL;
+    bplus_node* right = slot < parent -> count ? children[slot + 1] : NULL;
+    int minimum = t -> inner_capacity / 2;
+
+    if (left && left -> count > minimum)
+    {
+        bplus_move_separators(t, node, 1, node, 0, node -> count);
+        bplus_move_children(t, node, 1, node, 0, node -> count + 1);
+        copy(bplus_key(t, node, 0), bplus_key(t, parent, slot - 1), t -> key_size);
+        bplus_children(t, node)[0] = bplus_children(t, left)[left -> count];
+        copy(bplus_key(t, parent, slot - 1), bplus_key(t, left, left -> count - 1), t -> key_size);
+        left -> count--;
+        node -> count++;
+        return false;
+    }
+    if (right && right -> count > minimum)
+    {
+        copy(bplus_key(t, node, node -> count), bplus_key(t, parent, slot), t -> key_size);
+        bplus_children(t, node)[node -> count + 1] = bplus_children(t, right)[0];
+        copy(bplus_key(t, parent, slot), bplus_key(t, right, 0), t -> key_size);
+        bplus_move_separators(t, right, 0, right, 1, right -> count - 1);
+        bplus_move_children(t, right, 0, right, 1, right -> count);
+        right -> count--;
+        node -> count++;
+        return false;
+    }
+
+    if (!left)
+    {
+        left = node;
+        node = right;
+        slot++;
+    }
+    copy(bplus_key(t, left, left -> count), bplus_key(t, parent, slot - 1), t -> key_size);
+    bplus_move_separators(t, left, left -> count + 1, node, 0, node -> count);
+    bplus_move_children(t, left, left -> count + 1, node, 0, node -> count + 1);
+    left -> count += node -> count + 1;
+    bplus_free_node(t, node);
+    bplus_move_separators(t, parent, slot - 1, parent, slot, parent -> count - slot);
+    bplus_move_children(t, parent, slot, parent, slot + 1, parent -> count - slot);
+    parent -> count--;
+    return true;
+}
+
+/**
+ * Removes a key with its value. Nodes falling below half of their capacity
+ * borrow from a sibling or merge with it, up to the root
+ *
+ * @param t pointer to the tree
+ * @param key to remove
+ * @return status, FAILURE if missing
+ */
+int bplus_tree_erase(bplus_tree* t, const void* key)
+{
+    int status = FAILURE;
+    if (!t || !key || !t -> root)
+    {
+        return status;
+    }
+
+    bplus_node* path[BPLUS_TREE_MAX_HEIGHT];
+    int slots[BPLUS_TREE_MAX_HEIGHT];
+    int depth = 0;
+    bplus_node* leaf = t -> root;
+    while (!leaf -> leaf)
+    {
+        path[depth] = leaf;
+        slots[depth] = bplus_child_index(t, leaf, key);
+        leaf = bplus_children(t, leaf)[slots[depth]];
+        depth++;
+    }
+
+    int i = bplus_lower_bound(t, leaf, key);
+    if (i == leaf -> count || t -> cmp(bplus_key(t, leaf, i), key) != 0)
+    {
+        return status;
+    }
+    bplus_move_entries(t, leaf, i, leaf, i + 1, leaf -> count - i - 1);
+    leaf -> count--;
+    t -> size--;
+
+    // Separators above may still hold the removed key, they keep splitting
+    // the keys correctly
+    bplus_node* node = leaf;
+    int minimum = t -> leaf_capacity / 2;
+    while (depth > 0 && node -> count < minimum)
+    {
+        depth--;
+        bplus_node* parent = path[depth];
+        int merged = node -> leaf ? bplus_rebalance_leaf(t, parent, slots[depth])
+                                  : bplus_rebalance_inner(t, parent, slots[depth]);
+        if (!merged)
+        {
+            break;
+        }
+        node = parent;
+        minimum = t -> inner_capacity / 2;
+    }
+
+    // A root left with a single child is replaced by it
+    if (!t -> root -> leaf && t -> root -> count == 0)
+    {
+        bplus_node* root = t -> root;
+        t -> root = bplus_children(t, root)[0];
+        bplus_free_node(t, root);
+        t -> height--;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Releases every node below n
+ */
+void bplus_free_subtree(bplus_tree* t, bplus_node* n)
+{
+    if (!n -> leaf)
+    {
+        int i;
+        for (i = 0; i <= n -> count; ++i)
+        {
+            bplus_free_subtree(t, bplus_children(t, n)[i]);
+        }
+    }
+    bplus_free_node(t, n);
+}
+
+/**
+ * Removes every key
+ *
+ * @param t pointer to the tree
+ * @return status
+ */
+int bplus_tree_clear(bplus_tree* t)
+{
+    int status = FAILURE;
+    if (t)
+    {
+        if (t -> root)
+        {
+            bplus_free_subtree(t, t -> root);
+        }
+        t -> root = NULL;
+        t -> first = NULL;
+        t -> last = NULL;
+        t -> size = 0;
+        t -> height = 0;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Builds the tree from sorted keys in a single pass, filling the leaves
+ * and then every level above evenly and linking the leaves in order. Much
+ * faster than inserting the keys one by one
+ *
+ * @param t pointer to an empty tree
+ * @param keys vector of keys of key_size bytes, strictly increasing
+ * @param values vector of the values of the keys, NULL when values are
+ *               empty
+ * @return status, FAILURE if the tree is not empty or the keys are not
+ *         strictly increasing
+ */
+int bplus_tree_bulk_load(bplus_tree* t, vector* keys, vector* values)
+{
+    int status = FAILURE;
+    if (!t || !keys || t -> size != 0 || keys -> get_type_size(keys) != t -> key_size ||
+        (t -> value_size > 0 && (!values || values -> get_type_size(values) != t -> value_size ||
+                                 values -> size(values) != keys -> size(keys))))
+    {
+        return status;
+    }
+    int n = keys -> size(keys);
+    int i;
+    for (i = 1; i < n; ++i)
+    {
+        if (t -> cmp(item_address(keys, i - 1), item_address(keys, i)) >= 0)
+        {
+            return status;
+        }
+    }
+    bplus_tree_clear(t);
+    if (n == 0)
+    {
+        status = SUCCESS;
+        return status;
+    }
+
+    // Nodes of the level being built, with the smallest key below each
+    int count = (n + t -> leaf_capacity - 1) / t -> leaf_capacity;
+    bplus_node** level = malloc(sizeof(bplus_node*) * count);
+    const unsigned char** lowest = malloc(sizeof(unsigned char*) * count);
+    if (!level || !lowest)
+    {
+        free(level);
+        free(lowest);
+        return status;
+    }
+
+    int next = 0;
+    bplus_node* prev = NULL;
+    for (i = 0; i < count; ++i)
+    {
+        bplus_node* leaf = bplus_new_node(t, true);
+        if (!leaf)
+        {
+            // Leaves are only chained so far
+            while (t -> first)
+            {
+                bplus_node* built = t -> first;
+                t -> first = built -> next;
+                bplus_free_node(t, built);
+            }
+            t -> last = NULL;
+            free(level);
+            free(lowest);
+            return status;
+        }
+        int entries = n / count + (i < n % count);
+        int k;
+        for (k = 0; k < entries; ++k)
+        {
+            copy(bplus_key(t, leaf, k), item_address(keys, next + k), t -> key_size);
+            if (t -> value_size > 0)
+            {
+                copy(bplus_value(t, leaf, k), item_address(values, next + k), t -> value_size);
+            }
+        }
+        leaf -> count = entries;
+        leaf -> prev = prev;
+        if (prev)
+        {
+            prev -> next = leaf;
+        }
+        else
+        {
+            t -> first = leaf;
+        }
+        t -> last = leaf;
+        prev = leaf;
+        next += entries;
+        level[i] = leaf;
+        lowest[i] = bplus_key(t, leaf, 0);
+    }
+    t -> height = 1;
+
+    // Every level groups the nodes below it evenly, separated by their lowest keys
+    while (count > 1)
+    {
+        int fanout = t -> inner_capacity + 1;
+        int parents = (count + fanout - 1) / fanout;
+        int child = 0;
+        for (i = 0; i < parents; ++i)
+        {
+            bplus_node* parent = bplus_new_node(t, false);
+            if (!parent)
+            {
+                // The new parents and the nodes not adopted yet hold every node
+                int k;
+                for (k = 0; k < i; ++k)
+                {
+                    bplus_free_subtree(t, level[k]);
+                }
+                for (k = child; k < count; ++k)
+                {
+                    bplus_free_subtree(t, level[k]);
+                }
+                t -> first = NULL;
+                t -> last = NULL;
+                t -> height = 0;
+                free(level);
+                free(lowest);
+                return status;
+            }
+            int taken = count / parents + (i < count % parents);
+            int k;
+            for (k = 0; k < taken; ++k)
+            {
+                bplus_children(t, parent)[k] = level[child + k];
+                if (k > 0)
+                {
+                    copy(bplus_key(t, parent, k - 1), lowest[child + k], t -> key_size);
+                }
+            }
+            parent -> count = taken - 1;
+            level[i] = parent;
+            lowest[i] = lowest[child];
+            child += taken;
+        }
+        count = parents;
+        t -> height++;
+    }
+    t -> root = level[0];
+    t -> size = n;
+    free(level);
+    free(lowest);
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Releases every node and the scratch
+ *
+ * @param t pointer to the tree
+ * @return status
+ */
+int bplus_tree_free(bplus_tree* t)
+{
+    int status = bplus_tree_clear(t);
+    if (status == SUCCESS && t -> scratch)
+    {
+        t -> allocator.free(t -> allocator.context, t -> scratch, t -> scratch_bytes);
+        t -> scratch = NULL;
+    }
+    return status;
+}
+
+/**
+ * Places a cursor on the first key not before key
+ *
+ * @param t pointer to the tree
+ * @param key to look for
+ * @param c cursor, invalid if every key comes before key
+ * @return status
+ */
+int bplus_tree_lower_bound(bplus_tree* t, const void* key, bplus_cursor* c)
+{
+    int status = FAILURE;
+    if (!t || !key || !c)
+    {
+        return status;
+    }
+    c -> tree = t;
+    c -> leaf = bplus_find_leaf(t, key);
+    c -> index = c -> leaf ? bplus_lower_bound(t, c -> leaf, key) : 0;
+    // The key may only be found in the next leaf, when the separators are stale
+    while (c -> leaf && c -> index == c -> leaf -> count)
+    {
+        c -> leaf = c -> leaf -> next;
+        c -> index = 0;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Places a cursor on the smallest key
+ *
+ * @param t pointer to the tree
+ * @param c cursor, invalid if the tree is empty
+ * @return status
+ */
+int bplus_tree_first(bplus_tree* t, bplus_cursor* c)
+{
+    int status = FAILURE;
+    if (t && c)
+    {
+        c -> tree = t;
+        c -> leaf = t -> size > 0 ? t -> first : NULL;
+        c -> index = 0;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Places a cursor on the biggest key
+ *
+ * @param t pointer to the tree
+ * @param c cursor, invalid if the tree is empty
+ * @return status
+ */
+int bplus_tree_last(bplus_tree* t, bplus_cursor* c)
+{
+    int status = FAILURE;
+    if (t && c)
+    {
+        c -> tree = t;
+        c -> leaf = t -> size > 0 ? t -> last : NULL;
+        c -> index = c -> leaf ? c -> leaf -> count - 1 : 0;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Checks whether a cursor is on a key
+ */
+int bplus_cursor_valid(bplus_cursor* c)
+{
+    return c && c -> leaf;
+}
+
+/**
+ * Returns the key under a cursor, NULL if invalid
+ */
+void* bplus_cursor_key(bplus_cursor* c)
+{
+    return bplus_cursor_valid(c) ? bplus_key(c -> tree, c -> leaf, c -> index) : NULL;
+}
+
+/**
+ * Returns the value under a cursor, NULL if invalid or values are empty
+ */
+void* bplus_cursor_value(bplus_cursor* c)
+{
+    if (!bplus_cursor_valid(c) || c -> tree -> value_size == 0)
+    {
+        return NULL;
+    }
+    return bplus_value(c -> tree, c -> leaf, c -> index);
+}
+
+/**
+ * Moves a cursor to the next key, invalidating it past the last one
+ *
+ * @param c cursor
+ * @return status, FAILURE if the cursor was invalid
+ */
+int bplus_cursor_next(bplus_cursor* c)
+{
+    int status = FAILURE;
+    if (bplus_cursor_valid(c))
+    {
+        if (++c -> index == c -> leaf -> count)
+        {
+            c -> leaf = c -> leaf -> next;
+            c -> index = 0;
+        }
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Moves a cursor to the previous key, invalidating it before the first one
+ *
+ * @param c cursor
+ * @return status, FAILURE if the cursor was invalid
+ */
+int bplus_cursor_prev(bplus_cursor* c)
+{
+    int status = FAILURE;
+    if (bplus_cursor_valid(c))
+    {
+        if (c -> index-- == 0)
+        {
+            c -> leaf = c -> leaf -> prev;
+            c -> index = c -> leaf ? c -> leaf -> count - 1 : 0;
+        }
+        status = SUCCESS;
+    }
+    return status;
+}
+
+#endif
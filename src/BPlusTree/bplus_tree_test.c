@@ -0,0 +1,134 @@
+/**
+ * @file    bplus_tree_test.c - Main program for testing the B+-tree
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./bplus_tree.h"
+
+#define KEYS 100000
+
+/**
+ * Heap allocator which fails once its budget of allocations runs out
+ */
+int budget;
+
+void* budget_alloc(void* context, size_t size)
+{
+    (void) context;
+    return budget-- > 0 ? malloc(size) : NULL;
+}
+
+int main()
+{
+    bplus_tree t;
+    int status = bplus_tree_init(&t, sizeof(long long), sizeof(double), compare_long_long);
+    printf("Init:                   (status %d)\n", status);
+    printf("Leaf capacity:               %5d\n", t.leaf_capacity);
+    printf("Inner capacity:              %5d\n", t.inner_capacity);
+
+    long long key;
+    for (key = 0; key < KEYS; ++key)
+    {
+        long long shuffled = (key * 7919) % KEYS;
+        double value = shuffled * 0.5;
+        status |= bplus_tree_insert(&t, &shuffled, &value);
+    }
+    printf("Insert %d keys:     (status %d)\n", KEYS, status);
+    printf("Size:                       %6d\n", bplus_tree_size(&t));
+    printf("Height:                      %5d\n", bplus_tree_height(&t));
+
+    key = 4242;
+    double* value = bplus_tree_find(&t, &key);
+    printf("Find %lld:                %7.1f\n", key, value ? *value : -1.0);
+
+    status = SUCCESS;
+    for (key = 0; key < KEYS; key += 2)
+    {
+        status |= bplus_tree_erase(&t, &key);
+    }
+    printf("Erase even keys:        (status %d)\n", status);
+    printf("Size:                       %6d\n", bplus_tree_size(&t));
+    key = 4242;
+    printf("Contains %lld:               %5d\n", key, bplus_tree_contains(&t, &key));
+    printf("Erase %lld again:       (status %d)\n", key, bplus_tree_erase(&t, &key));
+
+    printf("\n");
+    bplus_cursor c;
+    key = 1000;
+    bplus_tree_lower_bound(&t, &key, &c);
+    while (bplus_cursor_valid(&c) && *(long long*) bplus_cursor_key(&c) < 1010)
+    {
+        printf("%lld -> %.1f\n", *(long long*) bplus_cursor_key(&c), *(double*) bplus_cursor_value(&c));
+        bplus_cursor_next(&c);
+    }
+    printf("\n");
+
+    bplus_tree_last(&t, &c);
+    int i;
+    for (i = 0; i < 3 && bplus_cursor_valid(&c); ++i)
+    {
+        printf("last - %d = %lld\n", i, *(long long*) bplus_cursor_key(&c));
+        bplus_cursor_prev(&c);
+    }
+    printf("\n");
+    printf("Free:                   (status %d)\n", bplus_tree_free(&t));
+
+    vector keys;
+    vector_init_packed(&keys, sizeof(long long), 0, 0);
+    for (key = 0; key < KEYS; ++key)
+    {
+        long long timestamp = key * 10;
+        keys.push_back(&keys, &timestamp);
+    }
+    status = bplus_tree_init(&t, sizeof(long long), 0, compare_long_long);
+    status |= bplus_tree_bulk_load(&t, &keys, NULL);
+    printf("Bulk load %d keys:  (status %d)\n", KEYS, status);
+    printf("Height:                      %5d\n", bplus_tree_height(&t));
+
+    long long low = 5000;
+    long long high = 6000;
+    int count = 0;
+    bplus_tree_lower_bound(&t, &low, &c);
+    while (bplus_cursor_valid(&c) && *(long long*) bplus_cursor_key(&c) < high)
+    {
+        count++;
+        bplus_cursor_next(&c);
+    }
+    printf("Keys in [%lld, %lld):      %5d\n", low, high, count);
+    printf("Bulk load non-empty:    (status %d)\n", bplus_tree_bulk_load(&t, &keys, NULL));
+    printf("Free:                   (status %d)\n", bplus_tree_free(&t));
+    keys.free(&keys);
+
+    // A failed insert leaves the tree unchanged
+    allocator limited = heap_allocator();
+    limited.alloc = budget_alloc;
+    budget = 40;
+    status = bplus_tree_init_allocator(&t, sizeof(long long), 0, compare_long_long, &limited);
+    for (key = 0; status == SUCCESS; ++key)
+    {
+        long long shuffled = (key * 7919) % KEYS;
+        status = bplus_tree_insert(&t, &shuffled, NULL);
+    }
+    printf("Insert out of memory:   (status %d)\n", status);
+    int inserted = (int) key - 1;
+    long long failed = ((key - 1) * 7919) % KEYS;
+    status = bplus_tree_size(&t) != inserted || bplus_tree_contains(&t, &failed);
+    for (key = 0; key < inserted; ++key)
+    {
+        long long shuffled = (key * 7919) % KEYS;
+        status |= !bplus_tree_contains(&t, &shuffled);
+    }
+    printf("Tree unchanged:         (status %d)\n", status);
+    budget = 1000;
+    status = bplus_tree_insert(&t, &failed, NULL);
+    printf("Insert again:           (status %d)\n", status | !bplus_tree_contains(&t, &failed));
+    printf("Size:                       %6d\n", bplus_tree_size(&t));
+    printf("Free:                   (status %d)\n", bplus_tree_free(&t));
+
+    return 0;
+}
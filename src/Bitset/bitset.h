@@ -0,0 +1,641 @@
+/**
+ * @file    bitset.h - Bit vector with rank and select
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#pragma once
+
+#include <stdint.h>
+#include "../Vector/vector.h"
+
+#define BITSET_WORD_BITS 64
+
+/**
+ * Words covered by an entry of the rank index
+ */
+#define BITSET_BLOCK_WORDS 8
+
+/**
+ * Sequence of bits packed 64 per word, with an index counting the set bits
+ * before every block of words so that rank and select only scan one block
+ */
+typedef struct bitset {
+
+    /**
+     * Packed vector of uint64_t, bit i is bit i % 64 of word i / 64. Bits
+     * past size in the last word are always zero
+     */
+    vector words;
+
+    /**
+     * Set bits before every block of BITSET_BLOCK_WORDS words, as uint64_t
+     */
+    vector ranks;
+
+    /**
+     * Number of bits
+     */
+    int size;
+
+    /**
+     * Whether the rank index matches the bits, cleared by every change
+     */
+    int rank_valid;
+
+} bitset;
+
+/**
+ * Counts the set bits of n words
+ */
+typedef long long (*bitset_popcount)(const uint64_t* words, size_t n);
+
+/**
+ * Counts the set bits of n words with the builtin, a software routine
+ * unless the program is built for a CPU with a popcount instruction
+ */
+long long bitset_popcount_builtin(const uint64_t* words, size_t n)
+{
+    long long count = 0;
+    size_t i;
+    for (i = 0; i < n; ++i)
+    {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+#ifdef KERNELS_X86
+/**
+ * Counts the set bits of n words with the POPCNT instruction
+ */
+__attribute__((target("popcnt")))
+long long bitset_popcount_hardware(const uint64_t* words, size_t n)
+{
+    long long count = 0;
+    size_t i;
+    for (i = 0; i < n; ++i)
+    {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+#endif
+
+/**
+ * Returns the popcount loop for the running CPU, selected on the first call
+ * and published with a single atomic store, as in kernels()
+ */
+bitset_popcount bitset_popcount_kernel()
+{
+    static bitset_popcount selected = NULL;
+    bitset_popcount kernel = __atomic_load_n(&selected, __ATOMIC_ACQUIRE);
+    if (!kernel)
+    {
+        kernel = bitset_popcount_builtin;
+#ifdef KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("popcnt"))
+        {
+            kernel = bitset_popcount_hardware;
+        }
+#endif
+        __atomic_store_n(&selected, kernel, __ATOMIC_RELEASE);
+    }
+    return kernel;
+}
+
+/**
+ * Returns the words of the bitset
+ */
+uint64_t* bitset_words(bitset* b)
+{
+    return b -> words.members.items;
+}
+
+/**
+ * Returns the number of words holding the bits
+ */
+int bitset_word_count(bitset* b)
+{
+    return b -> words.size(&b -> words);
+}
+
+/**
+ * Clears the bits past size in the last word
+ */
+void bitset_trim(bitset* b)
+{
+    int tail = b -> size % BITSET_WORD_BITS;
+    if (tail != 0)
+    {
+        bitset_words(b)[b -> size / BITSET_WORD_BITS] &= (UINT64_C(1) << tail) - 1;
+    }
+}
+
+/**
+ * Initializes a bitset of the given number of bits, all cleared, drawing
+ * its memory from the given allocator
+ *
+ * @param b pointer to the bitset
+ * @param bits number of bits
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int bitset_init_allocator(bitset* b, int bits, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!b || bits < 0)
+    {
+        return status;
+    }
+    vector_init_packed_allocator(&b -> words, sizeof(uint64_t), 0, 0, alloc);
+    vector_init_packed_allocator(&b -> ranks, sizeof(uint64_t), 0, 0, alloc);
+    b -> size = 0;
+    b -> rank_valid = false;
+    int words = (int) (((long long) bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS);
+    if (b -> words.resize(&b -> words, words) != SUCCESS)
+    {
+        return status;
+    }
+    b -> words.clear(&b -> words);
+    b -> size = bits;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes a bitset of the given number of bits, all cleared, on the heap
+ *
+ * @param b pointer to the bitset
+ * @param bits number of bits
+ * @return status
+ */
+int bitset_init(bitset* b, int bits)
+{
+    return bitset_init_allocator(b, bits, NULL);
+}
+
+/**
+ * Returns the number of bits
+ */
+int bitset_size(bitset* b)
+{
+    return b ? b -> size : VALUE_ERROR;
+}
+
+/**
+ * Changes the number of bits, new bits are cleared
+ *
+ * @param b pointer to the bitset
+ * @param bits new number of bits
+ * @return status
+ */
+int bitset_resize(bitset* b, int bits)
+{
+    int status = FAILURE;
+    if (!b || bits < 0)
+    {
+        return status;
+    }
+    int old_words = bitset_word_count(b);
+    int words = (int) (((long long) bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS);
+    if (b -> words.resize(&b -> words, words) != SUCCESS)
+    {
+        return status;
+    }
+    if (words > old_words)
+    {
+        uint64_t zero = 0;
+        set(bitset_words(b) + old_words, bitset_words(b) + words, &zero, sizeof(zero));
+    }
+    b -> size = bits;
+    bitset_trim(b);
+    b -> rank_valid = false;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Adds a bit at the end
+ *
+ * @param b pointer to the bitset
+ * @param bit value of the bit
+ * @return status
+ */
+int bitset_push_back(bitset* b, int bit)
+{
+    int status = FAILURE;
+    if (!b || b -> size == INT_MAX)
+    {
+        return status;
+    }
+    int index = b -> size;
+    if (index % BITSET_WORD_BITS == 0)
+    {
+        uint64_t zero = 0;
+        if (b -> words.push_back(&b -> words, &zero) != SUCCESS)
+        {
+            return status;
+        }
+    }
+    b -> size++;
+    if (bit)
+    {
+        bitset_words(b)[index / BITSET_WORD_BITS] |= UINT64_C(1) << (index % BITSET_WORD_BITS);
+    }
+    b -> rank_valid = false;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Returns the value of a bit, VALUE_ERROR out of bounds
+ */
+int bitset_test(bitset* b, int index)
+{
+    if (!b || index < 0 || index >= b -> size)
+    {
+        return VALUE_ERROR;
+    }
+    return (int) ((bitset_words(b)[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1);
+}
+
+/**
+ * Sets a bit
+ *
+ * @param b pointer to the bitset
+ * @param index of the bit
+ * @return status
+ */
+int bitset_set(bitset* b, int index)
+{
+    int status = FAILURE;
+    if (b && index >= 0 && index < b -> size)
+    {
+        bitset_words(b)[index / BITSET_WORD_BITS] |= UINT64_C(1) << (index % BITSET_WORD_BITS);
+        b -> rank_valid = false;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Clears a bit
+ *
+ * @param b pointer to the bitset
+ * @param index of the bit
+ * @return status
+ */
+int bitset_reset(bitset* b, int index)
+{
+    int status = FAILURE;
+    if (b && index >= 0 && index < b -> size)
+    {
+        bitset_words(b)[index / BITSET_WORD_BITS] &= ~(UINT64_C(1) << (index % BITSET_WORD_BITS));
+        b -> rank_valid = false;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Flips a bit
+ *
+ * @param b pointer to the bitset
+ * @param index of the bit
+ * @return status
+ */
+int bitset_flip(bitset* b, int index)
+{
+    int status = FAILURE;
+    if (b && index >= 0 && index < b -> size)
+    {
+        bitset_words(b)[index / BITSET_WORD_BITS] ^= UINT64_C(1) << (index % BITSET_WORD_BITS);
+        b -> rank_valid = false;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Sets or clears every bit
+ *
+ * @param b pointer to the bitset
+ * @param bit value of the bits
+ * @return status
+ */
+int bitset_fill(bitset* b, int bit)
+{
+    int status = FAILURE;
+    if (b)
+    {
+        uint64_t word = bit ? ~UINT64_C(0) : 0;
+        set(bitset_words(b), bitset_words(b) + bitset_word_count(b), &word, sizeof(word));
+        bitset_trim(b);
+        b -> rank_valid = false;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Bulk operations between two bitsets, a word at a time
+ */
+enum bitset_op {
+    BITSET_AND,
+    BITSET_OR,
+    BITSET_XOR,
+    BITSET_ANDNOT
+};
+
+/**
+ * Combines every word of dst with the one of src. Written as separate
+ * loops so that the compiler vectorizes each of them
+ *
+ * @param dst pointer to the bitset receiving the result
+ * @param src pointer to a bitset of the same size
+ * @param op operation
+ * @return status, FAILURE if the sizes differ
+ */
+int bitset_combine(bitset* dst, bitset* src, int op)
+{
+    int status = FAILURE;
+    if (!dst || !src || dst -> size != src -> size)
+    {
+        return status;
+    }
+    uint64_t* a = bitset_words(dst);
+    const uint64_t* b = bitset_words(src);
+    int n = bitset_word_count(dst);
+    int i;
+    switch (op)
+    {
+        case BITSET_AND:
+            for (i = 0; i < n; ++i)
+            {
+                a[i] &= b[i];
+            }
+            break;
+        case BITSET_OR:
+            for (i = 0; i < n; ++i)
+            {
+                a[i] |= b[i];
+            }
+            break;
+        case BITSET_XOR:
+            for (i = 0; i < n; ++i)
+            {
+                a[i] ^= b[i];
+            }
+            break;
+        case BITSET_ANDNOT:
+            for (i = 0; i < n; ++i)
+            {
+                a[i] &= ~b[i];
+            }
+            break;
+        default:
+            return status;
+    }
+    dst -> rank_valid = false;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * dst = dst & src
+ */
+int bitset_and(bitset* dst, bitset* src)
+{
+    return bitset_combine(dst, src, BITSET_AND);
+}
+
+/**
+ * dst = dst | src
+ */
+int bitset_or(bitset* dst, bitset* src)
+{
+    return bitset_combine(dst, src, BITSET_OR);
+}
+
+/**
+ * dst = dst ^ src
+ */
+int bitset_xor(bitset* dst, bitset* src)
+{
+    return bitset_combine(dst, src, BITSET_XOR);
+}
+
+/**
+ * dst = dst & ~src
+ */
+int bitset_andnot(bitset* dst, bitset* src)
+{
+    return bitset_combine(dst, src, BITSET_ANDNOT);
+}
+
+/**
+ * Returns the number of set bits
+ */
+long long bitset_count(bitset* b)
+{
+    if (!b)
+    {
+        return VALUE_ERROR;
+    }
+    return bitset_popcount_kernel()(bitset_words(b), bitset_word_count(b));
+}
+
+/**
+ * Looks for the first set bit at or after an index
+ *
+ * @param b pointer to the bitset
+ * @param from index to start from
+ * @return index of the bit, VALUE_ERROR if there is none
+ */
+int bitset_find_next(bitset* b, int from)
+{
+    if (!b || from < 0 || from >= b -> size)
+    {
+        return VALUE_ERROR;
+    }
+    const uint64_t* words = bitset_words(b);
+    int n = bitset_word_count(b);
+    int w = from / BITSET_WORD_BITS;
+    uint64_t word = words[w] & (~UINT64_C(0) << (from % BITSET_WORD_BITS));
+    while (word == 0)
+    {
+        if (++w == n)
+        {
+            return VALUE_ERROR;
+        }
+        word = words[w];
+    }
+    return w * BITSET_WORD_BITS + __builtin_ctzll(word);
+}
+
+/**
+ * Builds the rank index if a change made it stale
+ *
+ * @param b pointer to the bitset
+ * @return status
+ */
+int bitset_build_rank(bitset* b)
+{
+    int status = FAILURE;
+    if (!b)
+    {
+        return status;
+    }
+    if (b -> rank_valid)
+    {
+        status = SUCCESS;
+        return status;
+    }
+
+    int n = bitset_word_count(b);
+    int blocks = n / BITSET_BLOCK_WORDS + 1;
+    if (b -> ranks.resize(&b -> ranks, blocks) != SUCCESS)
+    {
+        return status;
+    }
+    const uint64_t* words = bitset_words(b);
+    uint64_t* ranks = b -> ranks.members.items;
+    bitset_popcount popcount = bitset_popcount_kernel();
+    uint64_t total = 0;
+    int block;
+    for (block = 0; block < blocks; ++block)
+    {
+        ranks[block] = total;
+        int first = block * BITSET_BLOCK_WORDS;
+        total += popcount(words + first, min(BITSET_BLOCK_WORDS, n - first));
+    }
+    b -> rank_valid = true;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Counts the set bits before an index, in constant time once the rank
+ * index is built. The index is rebuilt here after a change
+ *
+ * @param b pointer to the bitset
+ * @param index between 0 and size
+ * @return number of set bits in [0, index), VALUE_ERROR out of bounds
+ */
+long long bitset_rank(bitset* b, int index)
+{
+    if (!b || index < 0 || index > b -> size || bitset_build_rank(b) != SUCCESS)
+    {
+        return VALUE_ERROR;
+    }
+    const uint64_t* words = bitset_words(b);
+    int w = index / BITSET_WORD_BITS;
+    int block = w / BITSET_BLOCK_WORDS;
+    long long rank = ((const uint64_t*) b -> ranks.members.items)[block];
+    rank += bitset_popcount_kernel()(words + block * BITSET_BLOCK_WORDS, w - block * BITSET_BLOCK_WORDS);
+    if (index % BITSET_WORD_BITS != 0)
+    {
+        rank += __builtin_popcountll(words[w] & ((UINT64_C(1) << (index % BITSET_WORD_BITS)) - 1));
+    }
+    return rank;
+}
+
+/**
+ * Returns the position of the k-th set bit of a word, which has more
+ * than k set bits
+ */
+int bitset_select_word(uint64_t word, int k)
+{
+    // Skip whole bytes, then clear the lowest set bits of the right one
+    int shift = 0;
+    int count;
+    while ((count = __builtin_popcountll(word & 0xFF)) <= k)
+    {
+        k -= count;
+        word >>= 8;
+        shift += 8;
+    }
+    while (k-- > 0)
+    {
+        word &= word - 1;
+    }
+    return shift + __builtin_ctzll(word);
+}
+
+/**
+ * Finds the k-th set bit, counting from 0: binary search over the rank
+ * index, then a scan of one block
+ *
+ * @param b pointer to the bitset
+ * @param k rank of the set bit
+ * @return index of the bit, VALUE_ERROR if there are not more than k set bits
+ */
+int bitset_select(bitset* b, long long k)
+{
+    if (!b || k < 0 || bitset_build_rank(b) != SUCCESS)
+    {
+        return VALUE_ERROR;
+    }
+    const uint64_t* ranks = b -> ranks.members.items;
+    int blocks = b -> ranks.size(&b -> ranks);
+
+    // Last block with fewer than k + 1 set bits before it
+    int low = 0;
+    int high = blocks;
+    while (high - low > 1)
+    {
+        int middle = low + (high - low) / 2;
+        if (ranks[middle] <= (uint64_t) k)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    const uint64_t* words = bitset_words(b);
+    int n = bitset_word_count(b);
+    long long left = k - (long long) ranks[low];
+    int w;
+    for (w = low * BITSET_BLOCK_WORDS; w < n; ++w)
+    {
+        int count = __builtin_popcountll(words[w]);
+        if (left < count)
+        {
+            return w * BITSET_WORD_BITS + bitset_select_word(words[w], (int) left);
+        }
+        left -= count;
+    }
+    return VALUE_ERROR;
+}
+
+/**
+ * Releases the bits and the rank index
+ *
+ * @param b pointer to the bitset
+ * @return status
+ */
+int bitset_free(bitset* b)
+{
+    int status = FAILURE;
+    if (b)
+    {
+        status = b -> words.free(&b -> words);
+        status |= b -> ranks.free(&b -> ranks);
+        b -> size = 0;
+        b -> rank_valid = false;
+    }
+    return status;
+}
+
+#endif
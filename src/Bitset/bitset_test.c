@@ -0,0 +1,73 @@
+/**
+ * @file    bitset_test.c - Main program for testing the bitset
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./bitset.h"
+
+int main()
+{
+    bitset a;
+    int status = bitset_init(&a, 1000);
+    printf("Init 1000 bits:         (status %d)\n", status);
+
+    int i;
+    for (i = 0; i < 1000; i += 3)
+    {
+        status |= bitset_set(&a, i);
+    }
+    printf("Set multiples of 3:     (status %d)\n", status);
+    printf("Count:                       %5lld\n", bitset_count(&a));
+    printf("Test 9:                      %5d\n", bitset_test(&a, 9));
+    printf("Test 10:                     %5d\n", bitset_test(&a, 10));
+    printf("Set out of bounds:      (status %d)\n", bitset_set(&a, 1000));
+
+    status = bitset_flip(&a, 10);
+    status |= bitset_reset(&a, 9);
+    printf("Flip 10, reset 9:       (status %d)\n", status);
+    printf("Find next from 7:            %5d\n", bitset_find_next(&a, 7));
+    printf("Find next from 999:          %5d\n", bitset_find_next(&a, 999));
+
+    printf("Rank 100:                    %5lld\n", bitset_rank(&a, 100));
+    printf("Select 33:                   %5d\n", bitset_select(&a, 33));
+    printf("Select past count:           %5d\n", bitset_select(&a, bitset_count(&a)));
+
+    bitset b;
+    status = bitset_init(&b, 1000);
+    for (i = 0; i < 1000; i += 2)
+    {
+        status |= bitset_set(&b, i);
+    }
+    printf("Set multiples of 2:     (status %d)\n", status);
+
+    status = bitset_and(&a, &b);
+    printf("And:                    (status %d)\n", status);
+    printf("Count:                       %5lld\n", bitset_count(&a));
+    status = bitset_andnot(&b, &a);
+    printf("And not:                (status %d)\n", status);
+    printf("Count:                       %5lld\n", bitset_count(&b));
+    status = bitset_or(&a, &b);
+    printf("Or:                     (status %d)\n", status);
+    printf("Count:                       %5lld\n", bitset_count(&a));
+    status = bitset_xor(&a, &a);
+    printf("Xor with itself:        (status %d)\n", status);
+    printf("Count:                       %5lld\n", bitset_count(&a));
+
+    status = bitset_push_back(&b, true);
+    printf("Push back:              (status %d)\n", status);
+    printf("Size:                        %5d\n", bitset_size(&b));
+    printf("Rank of size:                %5lld\n", bitset_rank(&b, bitset_size(&b)));
+
+    bitset c;
+    bitset_init(&c, 10);
+    printf("And of other size:      (status %d)\n", bitset_and(&a, &c));
+
+    printf("Free:                   (status %d)\n", bitset_free(&a) | bitset_free(&b) | bitset_free(&c));
+
+    return 0;
+}
@@ -0,0 +1,503 @@
+/**
+ * @file    deque.h - Segmented vector with stable element addresses
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#pragma once
+
+#include "../Vector/vector.h"
+
+/**
+ * Target size of a chunk in Bytes. Chunks hold a power of two number of
+ * elements, at least one
+ */
+#ifndef DEQUE_CHUNK_BYTES
+#define DEQUE_CHUNK_BYTES 4096
+#endif
+
+/**
+ * Double-ended queue storing its elements in fixed-size chunks listed by a
+ * directory. Growing only allocates a new chunk and possibly grows the
+ * directory of pointers, so elements never move: their addresses stay
+ * valid until they are removed, and no growth needs twice the memory
+ */
+typedef struct deque {
+
+    /**
+     * Pointers to the chunks, NULL for the slots not in use
+     */
+    vector directory;
+
+    /**
+     * Directory index of the chunk holding the front element
+     */
+    int first;
+
+    /**
+     * Position of the front element inside its chunk
+     */
+    int offset;
+
+    /**
+     * Number of elements
+     */
+    int size;
+
+    /**
+     * Size of an element in Bytes
+     */
+    int type_size;
+
+    /**
+     * Log2 of the number of elements of a chunk
+     */
+    int chunk_shift;
+
+    /**
+     * Released chunk kept to avoid an allocation when the deque grows again
+     */
+    void* spare;
+
+    /**
+     * Allocator the chunks are drawn from
+     */
+    allocator allocator;
+
+} deque;
+
+/**
+ * Returns the number of elements of a chunk
+ */
+int deque_chunk_elements(deque* d)
+{
+    return 1 << d -> chunk_shift;
+}
+
+/**
+ * Returns the directory slot at index
+ */
+void** deque_slot(deque* d, int index)
+{
+    return item_address(&d -> directory, index);
+}
+
+/**
+ * Returns the number of directory slots from the first chunk to the one
+ * holding the back element
+ */
+int deque_used_chunks(deque* d)
+{
+    if (d -> size == 0)
+    {
+        return 0;
+    }
+    return ((d -> offset + d -> size - 1) >> d -> chunk_shift) + 1;
+}
+
+/**
+ * Returns the chunk at a directory index, allocating it when missing
+ */
+unsigned char* deque_chunk(deque* d, int index)
+{
+    void** slot = deque_slot(d, index);
+    if (!*slot)
+    {
+        size_t bytes = (size_t) deque_chunk_elements(d) * d -> type_size;
+        if (d -> spare)
+        {
+            *slot = d -> spare;
+            d -> spare = NULL;
+        }
+        else
+        {
+            *slot = d -> allocator.alloc(d -> allocator.context, bytes);
+        }
+    }
+    return *slot;
+}
+
+/**
+ * Releases the chunk at a directory index, keeping it as the spare one
+ * when there is none
+ */
+void deque_release_chunk(deque* d, int index)
+{
+    void** slot = deque_slot(d, index);
+    if (*slot)
+    {
+        if (!d -> spare)
+        {
+            d -> spare = *slot;
+        }
+        else
+        {
+            size_t bytes = (size_t) deque_chunk_elements(d) * d -> type_size;
+            d -> allocator.free(d -> allocator.context, *slot, bytes);
+        }
+        *slot = NULL;
+    }
+}
+
+/**
+ * Moves the used directory slots so that the first one lands at index
+ */
+void deque_move_directory(deque* d, int index)
+{
+    int used = deque_used_chunks(d);
+    if (index == d -> first)
+    {
+        return;
+    }
+    // Slots are moved with a single memmove, the chunks stay where they are
+    move(deque_slot(d, index), deque_slot(d, d -> first), (size_t) used * sizeof(void*));
+    int i;
+    for (i = d -> first; i < d -> first + used; ++i)
+    {
+        if (i < index || i >= index + used)
+        {
+            *deque_slot(d, i) = NULL;
+        }
+    }
+    d -> first = index;
+}
+
+/**
+ * Makes sure that the directory has a slot after the last used one. The used
+ * slots are moved to the front when at least half of the directory is free
+ * there, otherwise the directory grows
+ *
+ * @return status
+ */
+int deque_reserve_back(deque* d)
+{
+    int used = deque_used_chunks(d);
+    int slots = d -> directory.size(&d -> directory);
+    if (d -> first + used < slots)
+    {
+        return SUCCESS;
+    }
+    if (d -> first > 0 && d -> first >= used)
+    {
+        deque_move_directory(d, 0);
+        return SUCCESS;
+    }
+    void* none = NULL;
+    return d -> directory.push_back(&d -> directory, &none);
+}
+
+/**
+ * Makes sure that the directory has a slot before the first used one. The
+ * used slots are moved towards the back when enough of the directory is
+ * free there, otherwise the directory grows by as many slots as are used
+ *
+ * @return status
+ */
+int deque_reserve_front(deque* d)
+{
+    if (d -> first > 0)
+    {
+        return SUCCESS;
+    }
+    int used = deque_used_chunks(d);
+    int slots = d -> directory.size(&d -> directory);
+    int grow = max(used, 1);
+    if (slots - used < grow)
+    {
+        if (d -> directory.resize(&d -> directory, used + 2 * grow) != SUCCESS)
+        {
+            return FAILURE;
+        }
+        int i;
+        for (i = slots; i < used + 2 * grow; ++i)
+        {
+            *deque_slot(d, i) = NULL;
+        }
+        slots = used + 2 * grow;
+    }
+    deque_move_directory(d, slots - used - (slots - used) / 2);
+    return SUCCESS;
+}
+
+/**
+ * Initializes an empty deque drawing its memory from the given allocator
+ *
+ * @param d pointer to the deque
+ * @param type_size size of an element in Bytes
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int deque_init_allocator(deque* d, int type_size, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!d || type_size <= 0)
+    {
+        return status;
+    }
+    vector_init_packed_allocator(&d -> directory, sizeof(void*), 0, 0, alloc);
+    d -> allocator = alloc ? *alloc : heap_allocator();
+    d -> first = 0;
+    d -> offset = 0;
+    d -> size = 0;
+    d -> type_size = type_size;
+    d -> chunk_shift = 0;
+    while ((2 << d -> chunk_shift) * type_size <= DEQUE_CHUNK_BYTES)
+    {
+        d -> chunk_shift++;
+    }
+    d -> spare = NULL;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes an empty deque on the heap
+ *
+ * @param d pointer to the deque
+ * @param type_size size of an element in Bytes
+ * @return status
+ */
+int deque_init(deque* d, int type_size)
+{
+    return deque_init_allocator(d, type_size, NULL);
+}
+
+/**
+ * Returns the number of elements
+ */
+int deque_size(deque* d)
+{
+    return d ? d -> size : VALUE_ERROR;
+}
+
+/**
+ * Checks if the deque is empty
+ */
+int deque_empty(deque* d)
+{
+    return d ? d -> size == 0 : VALUE_ERROR;
+}
+
+/**
+ * Returns the element at an index, whose address stays valid until the
+ * element is removed
+ *
+ * @param d pointer to the deque
+ * @param index of the element
+ * @return pointer to the element, NULL out of bounds
+ */
+void* deque_at(deque* d, int index)
+{
+    if (!d || index < 0 || index >= d -> size)
+    {
+        return NULL;
+    }
+    int position = d -> offset + index;
+    unsigned char* chunk = *deque_slot(d, d -> first + (position >> d -> chunk_shift));
+    return chunk + (size_t) (position & (deque_chunk_elements(d) - 1)) * d -> type_size;
+}
+
+/**
+ * Returns the first element, NULL when empty
+ */
+void* deque_front(deque* d)
+{
+    return deque_at(d, 0);
+}
+
+/**
+ * Returns the last element, NULL when empty
+ */
+void* deque_back(deque* d)
+{
+    return d ? deque_at(d, d -> size - 1) : NULL;
+}
+
+/**
+ * Adds an element at the end
+ *
+ * @param d pointer to the deque
+ * @param value to add
+ * @return status
+ */
+int deque_push_back(deque* d, const void* value)
+{
+    int status = FAILURE;
+    if (!d || !value || d -> size == INT_MAX - deque_chunk_elements(d))
+    {
+        return status;
+    }
+
+    int position = d -> offset + d -> size;
+    if ((position & (deque_chunk_elements(d) - 1)) == 0 && deque_reserve_back(d) != SUCCESS)
+    {
+        return status;
+    }
+    unsigned char* chunk = deque_chunk(d, d -> first + (position >> d -> chunk_shift));
+    if (!chunk)
+    {
+        return status;
+    }
+    copy(chunk + (size_t) (position & (deque_chunk_elements(d) - 1)) * d -> type_size, value, d -> type_size);
+    d -> size++;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Adds an element at the beginning
+ *
+ * @param d pointer to the deque
+ * @param value to add
+ * @return status
+ */
+int deque_push_front(deque* d, const void* value)
+{
+    int status = FAILURE;
+    if (!d || !value || d -> size == INT_MAX - deque_chunk_elements(d))
+    {
+        return status;
+    }
+
+    if (d -> offset == 0)
+    {
+        if (deque_reserve_front(d) != SUCCESS)
+        {
+            return status;
+        }
+        if (!deque_chunk(d, d -> first - 1))
+        {
+            return status;
+        }
+        d -> first--;
+        d -> offset = deque_chunk_elements(d);
+    }
+    unsigned char* chunk = deque_chunk(d, d -> first);
+    if (!chunk)
+    {
+        return status;
+    }
+    d -> offset--;
+    d -> size++;
+    copy(chunk + (size_t) d -> offset * d -> type_size, value, d -> type_size);
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Removes the last element
+ *
+ * @param d pointer to the deque
+ * @param value receiving the element, may be NULL
+ * @return status
+ */
+int deque_pop_back(deque* d, void* value)
+{
+    int status = FAILURE;
+    if (!d || d -> size == 0)
+    {
+        return status;
+    }
+    if (value)
+    {
+        copy(value, deque_back(d), d -> type_size);
+    }
+    d -> size--;
+    int position = d -> offset + d -> size;
+    if ((position & (deque_chunk_elements(d) - 1)) == 0 || d -> size == 0)
+    {
+        deque_release_chunk(d, d -> first + (position >> d -> chunk_shift));
+    }
+    if (d -> size == 0)
+    {
+        d -> offset = 0;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Removes the first element
+ *
+ * @param d pointer to the deque
+ * @param value receiving the element, may be NULL
+ * @return status
+ */
+int deque_pop_front(deque* d, void* value)
+{
+    int status = FAILURE;
+    if (!d || d -> size == 0)
+    {
+        return status;
+    }
+    if (value)
+    {
+        copy(value, deque_front(d), d -> type_size);
+    }
+    d -> offset++;
+    d -> size--;
+    if (d -> offset == deque_chunk_elements(d) || d -> size == 0)
+    {
+        deque_release_chunk(d, d -> first);
+        d -> first++;
+        d -> offset = 0;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Removes every element, releasing the chunks
+ *
+ * @param d pointer to the deque
+ * @return status
+ */
+int deque_clear(deque* d)
+{
+    int status = FAILURE;
+    if (d)
+    {
+        int used = deque_used_chunks(d);
+        int i;
+        for (i = d -> first; i < d -> first + used; ++i)
+        {
+            deque_release_chunk(d, i);
+        }
+        d -> size = 0;
+        d -> offset = 0;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Releases the chunks and the directory
+ *
+ * @param d pointer to the deque
+ * @return status
+ */
+int deque_free(deque* d)
+{
+    int status = FAILURE;
+    if (d)
+    {
+        deque_clear(d);
+        if (d -> spare)
+        {
+            size_t bytes = (size_t) deque_chunk_elements(d) * d -> type_size;
+            d -> allocator.free(d -> allocator.context, d -> spare, bytes);
+            d -> spare = NULL;
+        }
+        d -> first = 0;
+        status = d -> directory.free(&d -> directory);
+    }
+    return status;
+}
+
+#endif
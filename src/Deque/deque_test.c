@@ -0,0 +1,91 @@
+/**
+ * @file    deque_test.c - Main program for testing the segmented deque
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./deque.h"
+
+#define ITEMS 100000
+
+int main()
+{
+    deque d;
+    int status = deque_init(&d, sizeof(int));
+    printf("Init:                   (status %d)\n", status);
+    printf("Elements per chunk:          %5d\n", deque_chunk_elements(&d));
+
+    int value;
+    int i;
+    for (i = 1; i <= 5; ++i)
+    {
+        status |= deque_push_back(&d, &i);
+        value = -i;
+        status |= deque_push_front(&d, &value);
+    }
+    printf("Push 5 at both ends:    (status %d)\n", status);
+    printf("Size:                        %5d\n", deque_size(&d));
+    printf("Front:                       %5d\n", *(int*) deque_front(&d));
+    printf("Back:                        %5d\n", *(int*) deque_back(&d));
+
+    printf("\n");
+    for (i = 0; i < deque_size(&d); ++i)
+    {
+        printf("d[%d] = %d\n", i, *(int*) deque_at(&d, i));
+    }
+    printf("\n");
+
+    status = deque_pop_front(&d, &value);
+    printf("Pop front %d:            (status %d)\n", value, status);
+    status = deque_pop_back(&d, &value);
+    printf("Pop back %d:              (status %d)\n", value, status);
+    printf("At out of bounds:       (null %d)\n", deque_at(&d, deque_size(&d)) == NULL);
+
+    // Addresses taken before growing must still point to the same elements
+    int* first = deque_front(&d);
+    int* last = deque_back(&d);
+    int stable = true;
+    for (i = 0; i < ITEMS; ++i)
+    {
+        status |= deque_push_back(&d, &i);
+        status |= deque_push_front(&d, &i);
+    }
+    stable &= first == deque_at(&d, ITEMS) && *first == -4;
+    stable &= last == deque_at(&d, ITEMS + 7) && *last == 4;
+    printf("Push %d at both ends: (status %d)\n", ITEMS, status);
+    printf("Addresses stable:       (status %d)\n", !stable);
+
+    int ordered = true;
+    for (i = 0; i < ITEMS; ++i)
+    {
+        ordered &= *(int*) deque_at(&d, i) == ITEMS - 1 - i;
+        ordered &= *(int*) deque_at(&d, ITEMS + 8 + i) == i;
+    }
+    printf("Elements in order:      (status %d)\n", !ordered);
+
+    // Used as a queue the directory is recycled instead of growing
+    status = deque_clear(&d);
+    for (i = 0; i < ITEMS; ++i)
+    {
+        status |= deque_push_back(&d, &i);
+        if (i >= 100)
+        {
+            status |= deque_pop_front(&d, &value);
+            ordered &= value == i - 100;
+        }
+    }
+    printf("Queue of 100:           (status %d)\n", status | !ordered);
+    printf("Directory slots:             %5d\n", d.directory.size(&d.directory));
+
+    status = deque_clear(&d);
+    printf("Clear:                  (status %d)\n", status);
+    printf("Empty:                       %5d\n", deque_empty(&d));
+    printf("Pop empty:              (status %d)\n", deque_pop_back(&d, NULL));
+    printf("Free:                   (status %d)\n", deque_free(&d));
+
+    return 0;
+}
@@ -0,0 +1,634 @@
+/**
+ * @file    flat_map.h - Sorted flat set and flat map stored in vectors
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#pragma once
+
+#include "../Vector/vector.h"
+
+/**
+ * Ordered set of unique elements kept sorted in a packed vector. Lookups
+ * are binary searches and scans walk contiguous memory, which suits sets
+ * read far more often than they are changed
+ */
+typedef struct flat_set {
+
+    /**
+     * Elements sorted by cmp, no two equivalent
+     */
+    vector items;
+
+    /**
+     * Order of the elements
+     */
+    comparator cmp;
+
+} flat_set;
+
+/**
+ * Ordered map from unique keys to values. Keys and values are kept in two
+ * packed vectors, sorted by key, so that binary searches only touch keys
+ */
+typedef struct flat_map {
+
+    /**
+     * Keys sorted by cmp, no two equivalent
+     */
+    vector keys;
+
+    /**
+     * Value of the key at the same index
+     */
+    vector values;
+
+    /**
+     * Order of the keys
+     */
+    comparator cmp;
+
+} flat_map;
+
+/**
+ * Merges n sorted unique keys, with their values, and count entries sorted
+ * by key, into out_keys and out_values. Equivalent keys are kept once,
+ * with the value of the entry coming last: entries win over the existing
+ * keys, later entries over earlier ones
+ *
+ * @param keys existing keys
+ * @param values existing values, may be NULL when value_size is 0
+ * @param n number of existing keys
+ * @param entries keys each followed by its value at value_offset, stable
+ *                sorted by key
+ * @param count number of entries
+ * @param entry_size distance between two consecutive entries in Bytes
+ * @param value_offset offset of the value inside an entry
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes
+ * @param cmp comparator of the keys
+ * @param out_keys receiving the merged keys, room for n + count
+ * @param out_values receiving the merged values, room for n + count
+ * @return number of merged keys
+ */
+size_t flat_merge(const unsigned char* keys, const unsigned char* values, size_t n,
+                  const unsigned char* entries, size_t count, size_t entry_size, size_t value_offset,
+                  size_t key_size, size_t value_size, comparator cmp,
+                  unsigned char* out_keys, unsigned char* out_values)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t merged = 0;
+    while (i < n || j < count)
+    {
+        const unsigned char* key;
+        const unsigned char* value;
+        if (i < n && (j == count || cmp(entries + j * entry_size, keys + i * key_size) >= 0))
+        {
+            key = keys + i * key_size;
+            value = value_size > 0 ? values + i * value_size : NULL;
+            i++;
+        }
+        else
+        {
+            key = entries + j * entry_size;
+            value = key + value_offset;
+            j++;
+        }
+
+        // Duplicates are next to each other, the last one overwrites the others
+        if (merged == 0 || cmp(key, out_keys + (merged - 1) * key_size) != 0)
+        {
+            merged++;
+        }
+        copy(out_keys + (merged - 1) * key_size, key, key_size);
+        if (value_size > 0)
+        {
+            copy(out_values + (merged - 1) * value_size, value, value_size);
+        }
+    }
+    return merged;
+}
+
+/**
+ * Initializes an empty flat set drawing its memory from the given allocator
+ *
+ * @param s pointer to the flat set
+ * @param type_size size of an element in Bytes
+ * @param cmp order of the elements
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int flat_set_init_allocator(flat_set* s, int type_size, comparator cmp, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!s || type_size <= 0 || !cmp)
+    {
+        return status;
+    }
+    vector_init_packed_allocator(&s -> items, type_size, 0, 0, alloc);
+    s -> cmp = cmp;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes an empty flat set on the heap
+ *
+ * @param s pointer to the flat set
+ * @param type_size size of an element in Bytes
+ * @param cmp order of the elements
+ * @return status
+ */
+int flat_set_init(flat_set* s, int type_size, comparator cmp)
+{
+    return flat_set_init_allocator(s, type_size, cmp, NULL);
+}
+
+/**
+ * Returns the number of elements
+ */
+int flat_set_size(flat_set* s)
+{
+    return s ? s -> items.size(&s -> items) : VALUE_ERROR;
+}
+
+/**
+ * Returns the element at a rank, NULL out of bounds
+ */
+void* flat_set_at(flat_set* s, int index)
+{
+    return s ? s -> items.at(&s -> items, index) : NULL;
+}
+
+/**
+ * Returns the index of the first element not before value
+ */
+int flat_set_lower_bound(flat_set* s, const void* value)
+{
+    return s ? s -> items.lower_bound(&s -> items, value, s -> cmp) : VALUE_ERROR;
+}
+
+/**
+ * Returns the index of the first element after value
+ */
+int flat_set_upper_bound(flat_set* s, const void* value)
+{
+    return s ? s -> items.upper_bound(&s -> items, value, s -> cmp) : VALUE_ERROR;
+}
+
+/**
+ * Looks for an element
+ *
+ * @param s pointer to the flat set
+ * @param value to look for
+ * @return index of the element, VALUE_ERROR if missing
+ */
+int flat_set_find(flat_set* s, const void* value)
+{
+    int index = flat_set_lower_bound(s, value);
+    if (index < 0 || index == s -> items.size(&s -> items) || s -> cmp(item_address(&s -> items, index), value) != 0)
+    {
+        return VALUE_ERROR;
+    }
+    return index;
+}
+
+/**
+ * Checks whether an element is in the set
+ */
+int flat_set_contains(flat_set* s, const void* value)
+{
+    return flat_set_find(s, value) != VALUE_ERROR;
+}
+
+/**
+ * Returns the elements from low included to high excluded
+ *
+ * @param s pointer to the flat set
+ * @param low first value of the range
+ * @param high value past the range
+ * @param first receiving the index of the first element in the range
+ * @return number of elements in the range
+ */
+int flat_set_range(flat_set* s, const void* low, const void* high, int* first)
+{
+    if (!s || !low || !high || !first)
+    {
+        return VALUE_ERROR;
+    }
+    *first = flat_set_lower_bound(s, low);
+    int last = flat_set_lower_bound(s, high);
+    return max(last - *first, 0);
+}
+
+/**
+ * Adds an element, shifting the following ones. Adding an element already
+ * in the set does nothing
+ *
+ * @param s pointer to the flat set
+ * @param value to add
+ * @return status
+ */
+int flat_set_insert(flat_set* s, const void* value)
+{
+    int status = FAILURE;
+    if (!s || !value)
+    {
+        return status;
+    }
+    int index = flat_set_lower_bound(s, value);
+    if (index < s -> items.size(&s -> items) && s -> cmp(item_address(&s -> items, index), value) == 0)
+    {
+        status = SUCCESS;
+        return status;
+    }
+    return s -> items.insert_range(&s -> items, index, value, 1);
+}
+
+/**
+ * Adds count elements at once: they are sorted, then merged with the set
+ * and deduplicated in a single pass into new storage. Much faster than
+ * count single insertions, which shift the elements every time
+ *
+ * @param s pointer to the flat set
+ * @param values array of count elements, in any order
+ * @param count number of elements
+ * @return status
+ */
+int flat_set_insert_batch(flat_set* s, const void* values, int count)
+{
+    int status = FAILURE;
+    if (!s || !values || count < 0)
+    {
+        return status;
+    }
+    if (count == 0)
+    {
+        status = SUCCESS;
+        return status;
+    }
+
+    vector* v = &s -> items;
+    allocator* a = &v -> members.allocator;
+    size_t type_size = v -> get_type_size(v);
+    size_t size = v -> size(v);
+    size_t sorted_bytes = 2 * (size_t) count * type_size;
+    size_t merged_capacity = size + count;
+    if (merged_capacity > INT_MAX)
+    {
+        return status;
+    }
+    unsigned char* sorted = a -> alloc(a -> context, sorted_bytes);
+    unsigned char* merged = a -> alloc(a -> context, merged_capacity * type_size);
+    if (!sorted || !merged)
+    {
+        if (sorted)
+        {
+            a -> free(a -> context, sorted, sorted_bytes);
+        }
+        if (merged)
+        {
+            a -> free(a -> context, merged, merged_capacity * type_size);
+        }
+        return status;
+    }
+
+    copy(sorted, values, (size_t) count * type_size);
+    merge_sort(sorted, count, type_size, s -> cmp, sorted + (size_t) count * type_size);
+    size_t n = flat_merge(v -> begin(v), NULL, size, sorted, count, type_size, 0, type_size, 0, s -> cmp,
+                          merged, NULL);
+    a -> free(a -> context, sorted, sorted_bytes);
+
+    // The merged array replaces the storage, no copy back
+    status = vector_adopt(v, merged, (int) n, (int) merged_capacity);
+    return status;
+}
+
+/**
+ * Removes an element
+ *
+ * @param s pointer to the flat set
+ * @param value to remove
+ * @return status, FAILURE if missing
+ */
+int flat_set_erase(flat_set* s, const void* value)
+{
+    int index = flat_set_find(s, value);
+    if (index == VALUE_ERROR)
+    {
+        return FAILURE;
+    }
+    return s -> items.erase_index(&s -> items, index);
+}
+
+/**
+ * Removes every element, keeping the capacity
+ */
+int flat_set_clear(flat_set* s)
+{
+    return s ? s -> items.resize(&s -> items, 0) : FAILURE;
+}
+
+/**
+ * Releases the storage
+ */
+int flat_set_free(flat_set* s)
+{
+    return s ? s -> items.free(&s -> items) : FAILURE;
+}
+
+/**
+ * Initializes an empty flat map drawing its memory from the given allocator
+ *
+ * @param m pointer to the flat map
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes
+ * @param cmp order of the keys
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int flat_map_init_allocator(flat_map* m, int key_size, int value_size, comparator cmp, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!m || key_size <= 0 || value_size <= 0 || !cmp)
+    {
+        return status;
+    }
+    vector_init_packed_allocator(&m -> keys, key_size, 0, 0, alloc);
+    vector_init_packed_allocator(&m -> values, value_size, 0, 0, alloc);
+    m -> cmp = cmp;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes an empty flat map on the heap
+ *
+ * @param m pointer to the flat map
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes
+ * @param cmp order of the keys
+ * @return status
+ */
+int flat_map_init(flat_map* m, int key_size, int value_size, comparator cmp)
+{
+    return flat_map_init_allocator(m, key_size, value_size, cmp, NULL);
+}
+
+/**
+ * Returns the number of keys
+ */
+int flat_map_size(flat_map* m)
+{
+    return m ? m -> keys.size(&m -> keys) : VALUE_ERROR;
+}
+
+/**
+ * Returns the key at a rank, NULL out of bounds
+ */
+void* flat_map_key(flat_map* m, int index)
+{
+    return m ? m -> keys.at(&m -> keys, index) : NULL;
+}
+
+/**
+ * Returns the value of the key at a rank, NULL out of bounds
+ */
+void* flat_map_value(flat_map* m, int index)
+{
+    return m ? m -> values.at(&m -> values, index) : NULL;
+}
+
+/**
+ * Returns the index of the first key not before key
+ */
+int flat_map_lower_bound(flat_map* m, const void* key)
+{
+    return m ? m -> keys.lower_bound(&m -> keys, key, m -> cmp) : VALUE_ERROR;
+}
+
+/**
+ * Returns the index of the first key after key
+ */
+int flat_map_upper_bound(flat_map* m, const void* key)
+{
+    return m ? m -> keys.upper_bound(&m -> keys, key, m -> cmp) : VALUE_ERROR;
+}
+
+/**
+ * Returns the index of a key, VALUE_ERROR if missing
+ */
+int flat_map_index(flat_map* m, const void* key)
+{
+    int index = flat_map_lower_bound(m, key);
+    if (index < 0 || index == m -> keys.size(&m -> keys) || m -> cmp(item_address(&m -> keys, index), key) != 0)
+    {
+        return VALUE_ERROR;
+    }
+    return index;
+}
+
+/**
+ * Looks for a key
+ *
+ * @param m pointer to the flat map
+ * @param key to look for
+ * @return pointer to its value, NULL if missing
+ */
+void* flat_map_find(flat_map* m, const void* key)
+{
+    int index = flat_map_index(m, key);
+    return index == VALUE_ERROR ? NULL : item_address(&m -> values, index);
+}
+
+/**
+ * Checks whether a key is in the map
+ */
+int flat_map_contains(flat_map* m, const void* key)
+{
+    return flat_map_index(m, key) != VALUE_ERROR;
+}
+
+/**
+ * Returns the keys from low included to high excluded
+ *
+ * @param m pointer to the flat map
+ * @param low first key of the range
+ * @param high key past the range
+ * @param first receiving the index of the first key in the range
+ * @return number of keys in the range
+ */
+int flat_map_range(flat_map* m, const void* low, const void* high, int* first)
+{
+    if (!m || !low || !high || !first)
+    {
+        return VALUE_ERROR;
+    }
+    *first = flat_map_lower_bound(m, low);
+    int last = flat_map_lower_bound(m, high);
+    return max(last - *first, 0);
+}
+
+/**
+ * Adds a key with its value, or replaces the value of a key already there
+ *
+ * @param m pointer to the flat map
+ * @param key to add
+ * @param value of the key
+ * @return status
+ */
+int flat_map_insert(flat_map* m, const void* key, const void* value)
+{
+    int status = FAILURE;
+    if (!m || !key || !value)
+    {
+        return status;
+    }
+    int index = flat_map_lower_bound(m, key);
+    if (index < m -> keys.size(&m -> keys) && m -> cmp(item_address(&m -> keys, index), key) == 0)
+    {
+        return m -> values.assign(&m -> values, value, index);
+    }
+    if (m -> keys.insert_range(&m -> keys, index, key, 1) != SUCCESS)
+    {
+        return status;
+    }
+    if (m -> values.insert_range(&m -> values, index, value, 1) != SUCCESS)
+    {
+        m -> keys.erase_index(&m -> keys, index);
+        return status;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Adds count keys with their values at once, like flat_set_insert_batch.
+ * A key given more than once, or already in the map, takes the value
+ * coming last
+ *
+ * @param m pointer to the flat map
+ * @param keys array of count keys, in any order
+ * @param values array of the count values of the keys
+ * @param count number of keys
+ * @return status
+ */
+int flat_map_insert_batch(flat_map* m, const void* keys, const void* values, int count)
+{
+    int status = FAILURE;
+    if (!m || !keys || !values || count < 0)
+    {
+        return status;
+    }
+    if (count == 0)
+    {
+        status = SUCCESS;
+        return status;
+    }
+
+    allocator* a = &m -> keys.members.allocator;
+    size_t key_size = m -> keys.get_type_size(&m -> keys);
+    size_t value_size = m -> values.get_type_size(&m -> values);
+    size_t size = m -> keys.size(&m -> keys);
+    size_t merged_capacity = size + count;
+    if (merged_capacity > INT_MAX)
+    {
+        return status;
+    }
+
+    // Keys are sorted along with their values, aligned as if allocated
+    size_t value_offset = ALLOCATOR_ALIGN(key_size);
+    size_t entry_size = ALLOCATOR_ALIGN(value_offset + value_size);
+    size_t entries_bytes = 2 * (size_t) count * entry_size;
+    unsigned char* entries = a -> alloc(a -> context, entries_bytes);
+    unsigned char* merged_keys = a -> alloc(a -> context, merged_capacity * key_size);
+    unsigned char* merged_values = a -> alloc(a -> context, merged_capacity * value_size);
+    if (!entries || !merged_keys || !merged_values)
+    {
+        if (entries)
+        {
+            a -> free(a -> context, entries, entries_bytes);
+        }
+        if (merged_keys)
+        {
+            a -> free(a -> context, merged_keys, merged_capacity * key_size);
+        }
+        if (merged_values)
+        {
+            a -> free(a -> context, merged_values, merged_capacity * value_size);
+        }
+        return status;
+    }
+
+    int i;
+    for (i = 0; i < count; ++i)
+    {
+        copy(entries + i * entry_size, (const unsigned char*) keys + i * key_size, key_size);
+        copy(entries + i * entry_size + value_offset, (const unsigned char*) values + i * value_size, value_size);
+    }
+    merge_sort(entries, count, entry_size, m -> cmp, entries + (size_t) count * entry_size);
+    size_t n = flat_merge(m -> keys.begin(&m -> keys), m -> values.begin(&m -> values), size,
+                          entries, count, entry_size, value_offset, key_size, value_size, m -> cmp,
+                          merged_keys, merged_values);
+    a -> free(a -> context, entries, entries_bytes);
+
+    status = vector_adopt(&m -> keys, merged_keys, (int) n, (int) merged_capacity);
+    status |= vector_adopt(&m -> values, merged_values, (int) n, (int) merged_capacity);
+    return status;
+}
+
+/**
+ * Removes a key with its value
+ *
+ * @param m pointer to the flat map
+ * @param key to remove
+ * @return status, FAILURE if missing
+ */
+int flat_map_erase(flat_map* m, const void* key)
+{
+    int index = flat_map_index(m, key);
+    if (index == VALUE_ERROR)
+    {
+        return FAILURE;
+    }
+    int status = m -> keys.erase_index(&m -> keys, index);
+    status |= m -> values.erase_index(&m -> values, index);
+    return status;
+}
+
+/**
+ * Removes every key, keeping the capacity
+ */
+int flat_map_clear(flat_map* m)
+{
+    int status = FAILURE;
+    if (m)
+    {
+        status = m -> keys.resize(&m -> keys, 0);
+        status |= m -> values.resize(&m -> values, 0);
+    }
+    return status;
+}
+
+/**
+ * Releases the storage
+ */
+int flat_map_free(flat_map* m)
+{
+    int status = FAILURE;
+    if (m)
+    {
+        status = m -> keys.free(&m -> keys);
+        status |= m -> values.free(&m -> values);
+    }
+    return status;
+}
+
+#endif
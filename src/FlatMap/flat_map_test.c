@@ -0,0 +1,91 @@
+/**
+ * @file    flat_map_test.c - Main program for testing the flat set and map
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./flat_map.h"
+
+int main()
+{
+    flat_set s;
+    int status = flat_set_init(&s, sizeof(int), compare_int);
+    printf("Set init:               (status %d)\n", status);
+
+    int values[] = { 42, 7, 19, 7, -3, 88, 0, 19 };
+    status = flat_set_insert_batch(&s, values, sizeof(values) / sizeof(values[0]));
+    printf("Insert batch of 8:      (status %d)\n", status);
+    int value = 25;
+    status = flat_set_insert(&s, &value);
+    printf("Insert %d:               (status %d)\n", value, status);
+    printf("Size:                        %5d\n", flat_set_size(&s));
+
+    printf("\n");
+    int i;
+    for (i = 0; i < flat_set_size(&s); ++i)
+    {
+        printf("s[%d] = %d\n", i, *(int*) flat_set_at(&s, i));
+    }
+    printf("\n");
+
+    value = 19;
+    printf("Find %d:                     %5d\n", value, flat_set_find(&s, &value));
+    value = 20;
+    printf("Contains %d:                 %5d\n", value, flat_set_contains(&s, &value));
+
+    int low = 0;
+    int high = 42;
+    int first;
+    int count = flat_set_range(&s, &low, &high, &first);
+    printf("Range [%d, %d):              %5d from %d\n", low, high, count, first);
+
+    value = 7;
+    printf("Erase %d:                (status %d)\n", value, flat_set_erase(&s, &value));
+    printf("Erase %d again:          (status %d)\n", value, flat_set_erase(&s, &value));
+    printf("Free:                   (status %d)\n", flat_set_free(&s));
+
+    flat_map m;
+    status = flat_map_init(&m, sizeof(int), sizeof(double), compare_int);
+    printf("Map init:               (status %d)\n", status);
+
+    int keys[1000];
+    double weights[1000];
+    for (i = 0; i < 1000; ++i)
+    {
+        keys[i] = (i * 7919) % 500;
+        weights[i] = i;
+    }
+    status = flat_map_insert_batch(&m, keys, weights, 1000);
+    printf("Insert batch of 1000:   (status %d)\n", status);
+    printf("Size:                        %5d\n", flat_map_size(&m));
+
+    int key = 123;
+    double* weight = flat_map_find(&m, &key);
+    printf("Find %d:                    %5.0f\n", key, weight ? *weight : -1.0);
+    double replaced = -1.0;
+    status = flat_map_insert(&m, &key, &replaced);
+    printf("Replace %d:             (status %d)\n", key, status);
+    printf("Find %d:                    %5.0f\n", key, *(double*) flat_map_find(&m, &key));
+
+    int sorted = true;
+    for (i = 1; i < flat_map_size(&m); ++i)
+    {
+        sorted &= *(int*) flat_map_key(&m, i - 1) < *(int*) flat_map_key(&m, i);
+    }
+    printf("Keys sorted and unique: (status %d)\n", !sorted);
+
+    low = 100;
+    high = 200;
+    count = flat_map_range(&m, &low, &high, &first);
+    printf("Range [%d, %d):           %5d from %d\n", low, high, count, first);
+
+    printf("Erase %d:               (status %d)\n", key, flat_map_erase(&m, &key));
+    printf("Contains %d:                %5d\n", key, flat_map_contains(&m, &key));
+    printf("Free:                   (status %d)\n", flat_map_free(&m));
+
+    return 0;
+}
@@ -0,0 +1,653 @@
+/**
+ * @file    hash_map.h - Open-addressing hash map with control-byte probing
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#pragma once
+
+#include <stdint.h>
+#include "../utils.h"
+#include "../Allocator/allocator.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Number of control bytes inspected at once while probing
+ */
+#define HASH_MAP_GROUP 16
+
+/**
+ * Control byte of a slot never used
+ */
+#define HASH_MAP_EMPTY ((int8_t) -128)
+
+/**
+ * Control byte of a slot whose entry was erased
+ */
+#define HASH_MAP_DELETED ((int8_t) -2)
+
+/**
+ * Maximum load, in eighths of the capacity
+ */
+#define HASH_MAP_MAX_LOAD 7
+
+/**
+ * Keys and values start on a multiple of this many Bytes inside a slot
+ */
+#define HASH_MAP_SLOT_ALIGN 8
+
+/**
+ * Largest number of slots
+ */
+#define HASH_MAP_MAX_CAPACITY (1 << 30)
+
+/**
+ * Hashes a key
+ *
+ * @param key pointer to the key
+ * @param key_size size of the key in Bytes
+ * @return hash of the key
+ */
+typedef uint64_t (*hash_function)(const void* key, int key_size);
+
+/**
+ * Tells whether two keys are equal
+ *
+ * @param a pointer to the first key
+ * @param b pointer to the second key
+ * @param key_size size of the keys in Bytes
+ * @return true if the keys are equal
+ */
+typedef int (*equal_function)(const void* a, const void* b, int key_size);
+
+/**
+ * Hash map storing keys and values of fixed size by copy. Every slot has a
+ * control byte holding 7 bits of the hash of its key, or telling that the
+ * slot is empty or deleted. Lookups compare a whole group of control bytes
+ * at once and only touch the slots whose byte matches
+ */
+typedef struct hash_map {
+
+    /**
+     * Control bytes: capacity of them followed by a copy of the first
+     * HASH_MAP_GROUP, so that a group can be loaded from any slot
+     */
+    int8_t* control;
+
+    /**
+     * Slots, each a key followed by its value
+     */
+    unsigned char* slots;
+
+    /**
+     * Number of entries
+     */
+    int size;
+
+    /**
+     * Number of slots, a power of two
+     */
+    int capacity;
+
+    /**
+     * Entries that can still be added before rehashing
+     */
+    int growth_left;
+
+    /**
+     * Size of a key in Bytes
+     */
+    int key_size;
+
+    /**
+     * Size of a value in Bytes, zero for a set
+     */
+    int value_size;
+
+    /**
+     * Offset of the value inside a slot
+     */
+    int value_offset;
+
+    /**
+     * Distance between two consecutive slots in Bytes
+     */
+    int slot_size;
+
+    /**
+     * Hashes the keys
+     */
+    hash_function hash;
+
+    /**
+     * Compares the keys
+     */
+    equal_function equal;
+
+    /**
+     * Allocator the control bytes and slots are drawn from
+     */
+    allocator allocator;
+
+} hash_map;
+
+/**
+ * Mixes the bits of a word so that every input bit affects every output bit
+ */
+uint64_t hash_mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * Default hash: the key is read one word at a time
+ */
+uint64_t hash_bytes(const void* key, int key_size)
+{
+    const unsigned char* bytes = key;
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (uint64_t) key_size;
+    int i = 0;
+    for (; i + (int) sizeof(kernel_word) <= key_size; i += sizeof(kernel_word))
+    {
+        h = hash_mix(h ^ *(const kernel_word*) (bytes + i));
+    }
+    if (i < key_size)
+    {
+        uint64_t tail = 0;
+        int shift = 0;
+        for (; i < key_size; ++i, shift += 8)
+        {
+            tail |= (uint64_t) bytes[i] << shift;
+        }
+        h = hash_mix(h ^ tail);
+    }
+    return h;
+}
+
+/**
+ * Default equality: the keys are compared byte by byte
+ */
+int equal_bytes(const void* a, const void* b, int key_size)
+{
+    return compare(a, b, key_size) == 0;
+}
+
+/**
+ * Returns a bit mask of the bytes of the group starting at index that are
+ * equal to value
+ */
+unsigned hash_map_match(const hash_map* m, int index, int8_t value)
+{
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i*) (m -> control + index));
+    return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value)));
+#else
+    unsigned mask = 0;
+    int i;
+    for (i = 0; i < HASH_MAP_GROUP; ++i)
+    {
+        mask |= (unsigned) (m -> control[index + i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Returns a bit mask of the bytes of the group starting at index that are
+ * empty or deleted
+ */
+unsigned hash_map_match_free(const hash_map* m, int index)
+{
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i*) (m -> control + index));
+    return (unsigned) _mm_movemask_epi8(group);
+#else
+    unsigned mask = 0;
+    int i;
+    for (i = 0; i < HASH_MAP_GROUP; ++i)
+    {
+        mask |= (unsigned) (m -> control[index + i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Returns the address of the slot at index
+ */
+unsigned char* hash_map_slot(const hash_map* m, int index)
+{
+    return m -> slots + (size_t) index * m -> slot_size;
+}
+
+/**
+ * Sets the control byte of a slot and its copy past the end
+ */
+void hash_map_set_control(hash_map* m, int index, int8_t value)
+{
+    m -> control[index] = value;
+    if (index < HASH_MAP_GROUP)
+    {
+        m -> control[m -> capacity + index] = value;
+    }
+}
+
+/**
+ * Returns the number of entries a table of the given capacity can hold
+ */
+int hash_map_max_load(int capacity)
+{
+    return (int) ((long long) capacity * HASH_MAP_MAX_LOAD / 8);
+}
+
+/**
+ * Returns the index of the slot holding key, VALUE_ERROR if absent
+ */
+int hash_map_lookup(const hash_map* m, const void* key, uint64_t hash)
+{
+    int mask = m -> capacity - 1;
+    int8_t tag = (int8_t) (hash & 0x7f);
+    int index = (int) ((hash >> 7) & mask);
+    int step = 0;
+    while (step <= mask)
+    {
+        unsigned matches = hash_map_match(m, index, tag);
+        while (matches)
+        {
+            int slot = (index + __builtin_ctz(matches)) & mask;
+            if (m -> equal(hash_map_slot(m, slot), key, m -> key_size))
+            {
+                return slot;
+            }
+            matches &= matches - 1;
+        }
+        if (hash_map_match(m, index, HASH_MAP_EMPTY))
+        {
+            break;
+        }
+        step += HASH_MAP_GROUP;
+        index = (index + step) & mask;
+    }
+    return VALUE_ERROR;
+}
+
+/**
+ * Returns the index of the first empty or deleted slot on the probe
+ * sequence of hash. The table must have at least one
+ */
+int hash_map_free_slot(const hash_map* m, uint64_t hash)
+{
+    int mask = m -> capacity - 1;
+    int index = (int) ((hash >> 7) & mask);
+    int step = 0;
+    unsigned free_slots;
+    while (!(free_slots = hash_map_match_free(m, index)))
+    {
+        step += HASH_MAP_GROUP;
+        index = (index + step) & mask;
+    }
+    return (index + __builtin_ctz(free_slots)) & mask;
+}
+
+/**
+ * Allocates empty storage for capacity slots, keeping the entries of the
+ * previous storage
+ *
+ * @return status
+ */
+int hash_map_resize(hash_map* m, int capacity)
+{
+    int status = FAILURE;
+    int8_t* control = m -> allocator.alloc(m -> allocator.context, (size_t) capacity + HASH_MAP_GROUP);
+    unsigned char* slots = m -> allocator.alloc(m -> allocator.context, (size_t) capacity * m -> slot_size);
+    if (!control || !slots)
+    {
+        m -> allocator.free(m -> allocator.context, control, (size_t) capacity + HASH_MAP_GROUP);
+        m -> allocator.free(m -> allocator.context, slots, (size_t) capacity * m -> slot_size);
+        return status;
+    }
+
+    int8_t* old_control = m -> control;
+    unsigned char* old_slots = m -> slots;
+    int old_capacity = m -> capacity;
+    int8_t empty = HASH_MAP_EMPTY;
+    set(control, control + capacity + HASH_MAP_GROUP, &empty, sizeof(empty));
+    m -> control = control;
+    m -> slots = slots;
+    m -> capacity = capacity;
+    m -> growth_left = hash_map_max_load(capacity) - m -> size;
+
+    int i;
+    for (i = 0; i < old_capacity; ++i)
+    {
+        if (old_control[i] >= 0)
+        {
+            const unsigned char* entry = old_slots + (size_t) i * m -> slot_size;
+            uint64_t hash = m -> hash(entry, m -> key_size);
+            int slot = hash_map_free_slot(m, hash);
+            hash_map_set_control(m, slot, (int8_t) (hash & 0x7f));
+            copy(hash_map_slot(m, slot), entry, m -> slot_size);
+        }
+    }
+
+    if (old_control)
+    {
+        m -> allocator.free(m -> allocator.context, old_control, (size_t) old_capacity + HASH_MAP_GROUP);
+        m -> allocator.free(m -> allocator.context, old_slots, (size_t) old_capacity * m -> slot_size);
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Returns the smallest power of two number of slots, not below minimum,
+ * holding entries without rehashing
+ */
+int hash_map_capacity_for(int entries, int minimum)
+{
+    int capacity = HASH_MAP_GROUP;
+    while ((capacity < minimum || hash_map_max_load(capacity) < entries) && capacity < HASH_MAP_MAX_CAPACITY)
+    {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/**
+ * Initializes an empty hash map drawing its memory from the given allocator
+ *
+ * @param m pointer to the hash map
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes, zero to use the map as a set
+ * @param capacity number of entries to make room for
+ * @param hash function hashing the keys, NULL for hash_bytes
+ * @param equal function comparing the keys, NULL for equal_bytes
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int hash_map_init_allocator(hash_map* m, int key_size, int value_size, int capacity,
+                            hash_function hash, equal_function equal, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!m || key_size <= 0 || value_size < 0 || capacity < 0)
+    {
+        return status;
+    }
+
+    // Keys and values start on a word boundary, as in the slot layout of vector_init
+    m -> key_size = key_size;
+    m -> value_size = value_size;
+    m -> value_offset = (key_size + HASH_MAP_SLOT_ALIGN - 1) / HASH_MAP_SLOT_ALIGN * HASH_MAP_SLOT_ALIGN;
+    m -> slot_size = (m -> value_offset + value_size + HASH_MAP_SLOT_ALIGN - 1) / HASH_MAP_SLOT_ALIGN * HASH_MAP_SLOT_ALIGN;
+    m -> hash = hash ? hash : hash_bytes;
+    m -> equal = equal ? equal : equal_bytes;
+    m -> allocator = alloc ? *alloc : heap_allocator();
+    m -> control = NULL;
+    m -> slots = NULL;
+    m -> size = 0;
+    m -> capacity = 0;
+    m -> growth_left = 0;
+    status = hash_map_resize(m, hash_map_capacity_for(capacity, 0));
+    return status;
+}
+
+/**
+ * Initializes an empty hash map on the heap
+ *
+ * @param m pointer to the hash map
+ * @param key_size size of a key in Bytes
+ * @param value_size size of a value in Bytes, zero to use the map as a set
+ * @param capacity number of entries to make room for
+ * @param hash function hashing the keys, NULL for hash_bytes
+ * @param equal function comparing the keys, NULL for equal_bytes
+ * @return status
+ */
+int hash_map_init(hash_map* m, int key_size, int value_size, int capacity, hash_function hash, equal_function equal)
+{
+    return hash_map_init_allocator(m, key_size, value_size, capacity, hash, equal, NULL);
+}
+
+/**
+ * Returns the number of entries
+ */
+int hash_map_size(hash_map* m)
+{
+    return m ? m -> size : VALUE_ERROR;
+}
+
+/**
+ * Returns the number of slots
+ */
+int hash_map_capacity(hash_map* m)
+{
+    return m ? m -> capacity : VALUE_ERROR;
+}
+
+/**
+ * Looks up a key
+ *
+ * @param m pointer to the hash map
+ * @param key to look up
+ * @return pointer to the value of the key, NULL if absent
+ */
+void* hash_map_find(hash_map* m, const void* key)
+{
+    if (!m || !key)
+    {
+        return NULL;
+    }
+    int slot = hash_map_lookup(m, key, m -> hash(key, m -> key_size));
+    return slot == VALUE_ERROR ? NULL : hash_map_slot(m, slot) + m -> value_offset;
+}
+
+/**
+ * Checks whether a key is in the map
+ *
+ * @param m pointer to the hash map
+ * @param key to look up
+ * @return true if the key is present
+ */
+int hash_map_contains(hash_map* m, const void* key)
+{
+    return hash_map_find(m, key) != NULL;
+}
+
+/**
+ * Rebuilds the table with room for at least the given number of slots,
+ * dropping the deleted ones. The capacity never goes below what the current
+ * entries need
+ *
+ * @param m pointer to the hash map
+ * @param capacity minimum number of slots
+ * @return status
+ */
+int hash_map_rehash(hash_map* m, int capacity)
+{
+    int status = FAILURE;
+    if (!m || capacity < 0)
+    {
+        return status;
+    }
+    status = hash_map_resize(m, hash_map_capacity_for(m -> size, capacity));
+    return status;
+}
+
+/**
+ * Makes room for at least the given number of entries without rehashing
+ *
+ * @param m pointer to the hash map
+ * @param entries number of entries
+ * @return status
+ */
+int hash_map_reserve(hash_map* m, int entries)
+{
+    int status = FAILURE;
+    if (!m || entries < 0)
+    {
+        return status;
+    }
+    status = SUCCESS;
+    if (entries - m -> size > m -> growth_left)
+    {
+        status = hash_map_resize(m, hash_map_capacity_for(entries, m -> capacity));
+    }
+    return status;
+}
+
+/**
+ * Inserts a key with its value, replacing the value when the key is present
+ *
+ * @param m pointer to the hash map
+ * @param key to insert
+ * @param value of the key, ignored when the value size is zero
+ * @return status
+ */
+int hash_map_insert(hash_map* m, const void* key, const void* value)
+{
+    int status = FAILURE;
+    if (!m || !key || (!value && m -> value_size > 0))
+    {
+        return status;
+    }
+
+    uint64_t hash = m -> hash(key, m -> key_size);
+    int slot = hash_map_lookup(m, key, hash);
+    if (slot == VALUE_ERROR)
+    {
+        slot = hash_map_free_slot(m, hash);
+        if (m -> growth_left == 0 && m -> control[slot] == HASH_MAP_EMPTY)
+        {
+            // Rehash at the same capacity when deleted slots are what fills the table
+            int capacity = m -> size < hash_map_max_load(m -> capacity) / 2 ? m -> capacity : m -> capacity * 2;
+            if (capacity > HASH_MAP_MAX_CAPACITY || hash_map_resize(m, capacity) != SUCCESS)
+            {
+                return status;
+            }
+            slot = hash_map_free_slot(m, hash);
+        }
+        m -> growth_left -= m -> control[slot] == HASH_MAP_EMPTY;
+        hash_map_set_control(m, slot, (int8_t) (hash & 0x7f));
+        copy(hash_map_slot(m, slot), key, m -> key_size);
+        m -> size++;
+    }
+    if (m -> value_size > 0)
+    {
+        copy(hash_map_slot(m, slot) + m -> value_offset, value, m -> value_size);
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Removes a key with its value
+ *
+ * @param m pointer to the hash map
+ * @param key to remove
+ * @return status, FAILURE if the key is absent
+ */
+int hash_map_erase(hash_map* m, const void* key)
+{
+    int status = FAILURE;
+    if (!m || !key)
+    {
+        return status;
+    }
+    int slot = hash_map_lookup(m, key, m -> hash(key, m -> key_size));
+    if (slot != VALUE_ERROR)
+    {
+        hash_map_set_control(m, slot, HASH_MAP_DELETED);
+        m -> size--;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Iterates over the entries in no particular order. Start with *cursor = 0
+ *
+ * @param m pointer to the hash map
+ * @param cursor position of the iteration, updated on every call
+ * @param key receiving a pointer to the key of the next entry
+ * @param value receiving a pointer to the value of the next entry, may be NULL
+ * @return true while an entry is returned
+ */
+int hash_map_next(hash_map* m, int* cursor, const void** key, void** value)
+{
+    if (!m || !cursor || !key)
+    {
+        return false;
+    }
+    while (*cursor < m -> capacity)
+    {
+        int slot = (*cursor)++;
+        if (m -> control[slot] >= 0)
+        {
+            *key = hash_map_slot(m, slot);
+            if (value)
+            {
+                *value = hash_map_slot(m, slot) + m -> value_offset;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Removes every entry, keeping the capacity
+ *
+ * @param m pointer to the hash map
+ * @return status
+ */
+int hash_map_clear(hash_map* m)
+{
+    int status = FAILURE;
+    if (m && m -> control)
+    {
+        int8_t empty = HASH_MAP_EMPTY;
+        set(m -> control, m -> control + m -> capacity + HASH_MAP_GROUP, &empty, sizeof(empty));
+        m -> size = 0;
+        m -> growth_left = hash_map_max_load(m -> capacity);
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Releases the storage of the hash map
+ *
+ * @param m pointer to the hash map
+ * @return status
+ */
+int hash_map_free(hash_map* m)
+{
+    int status = FAILURE;
+    if (m && m -> control)
+    {
+        m -> allocator.free(m -> allocator.context, m -> control, (size_t) m -> capacity + HASH_MAP_GROUP);
+        m -> allocator.free(m -> allocator.context, m -> slots, (size_t) m -> capacity * m -> slot_size);
+        m -> control = NULL;
+        m -> slots = NULL;
+        m -> size = 0;
+        m -> capacity = 0;
+        m -> growth_left = 0;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file    hash_map_test.c - Main program for testing the hash map
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./hash_map.h"
+
+int main()
+{
+    hash_map m;
+    int status = hash_map_init(&m, sizeof(int), sizeof(double), 0, NULL, NULL);
+    printf("Init:                   (status %d)\n", status);
+    printf("Initial capacity:            %5d\n", hash_map_capacity(&m));
+
+    int key;
+    for (key = 0; key < 1000; ++key)
+    {
+        double value = key * 0.5;
+        status |= hash_map_insert(&m, &key, &value);
+    }
+    printf("Insert 1000 keys:       (status %d)\n", status);
+    printf("Size:                        %5d\n", hash_map_size(&m));
+    printf("Capacity:                    %5d\n", hash_map_capacity(&m));
+
+    key = 42;
+    double* value = hash_map_find(&m, &key);
+    printf("Find %d:                     %5.1f\n", key, value ? *value : -1.0);
+    double replaced = 7.0;
+    printf("Replace %d:             (status %d)\n", key, hash_map_insert(&m, &key, &replaced));
+    printf("Find %d:                     %5.1f\n", key, *(double*) hash_map_find(&m, &key));
+
+    key = 5000;
+    printf("Contains %d:               %5d\n", key, hash_map_contains(&m, &key));
+
+    status = SUCCESS;
+    for (key = 0; key < 1000; key += 2)
+    {
+        status |= hash_map_erase(&m, &key);
+    }
+    printf("Erase even keys:        (status %d)\n", status);
+    key = 0;
+    printf("Erase %d again:          (status %d)\n", key, hash_map_erase(&m, &key));
+    printf("Size:                        %5d\n", hash_map_size(&m));
+
+    int cursor = 0;
+    int odd = 0;
+    const void* k;
+    while (hash_map_next(&m, &cursor, &k, NULL))
+    {
+        odd += *(const int*) k % 2;
+    }
+    printf("Odd keys visited:            %5d\n", odd);
+
+    printf("Rehash:                 (status %d)\n", hash_map_rehash(&m, 0));
+    printf("Capacity:                    %5d\n", hash_map_capacity(&m));
+    printf("Reserve 100000:         (status %d)\n", hash_map_reserve(&m, 100000));
+    printf("Capacity:                    %5d\n", hash_map_capacity(&m));
+    printf("Clear:                  (status %d)\n", hash_map_clear(&m));
+    printf("Size:                        %5d\n", hash_map_size(&m));
+    printf("Free:                   (status %d)\n", hash_map_free(&m));
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+/**
+ * @file    concurrent_vector.h - Append-only vector many threads can push to
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#pragma once
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "../utils.h"
+#include "../Allocator/allocator.h"
+
+/**
+ * Number of elements of the first bucket, a power of two. Bucket b holds
+ * CONCURRENT_VECTOR_FIRST_BUCKET << b elements
+ */
+#ifndef CONCURRENT_VECTOR_FIRST_BUCKET
+#define CONCURRENT_VECTOR_FIRST_BUCKET 64
+#endif
+
+/**
+ * Maximum number of buckets. Together they hold
+ * (CONCURRENT_VECTOR_FIRST_BUCKET << 48) - CONCURRENT_VECTOR_FIRST_BUCKET
+ * elements, about 2^54 with the default first bucket, and pushes past
+ * that fail
+ */
+#define CONCURRENT_VECTOR_BUCKETS 48
+
+#ifndef CONCURRENT_VECTOR_CACHE_LINE
+#define CONCURRENT_VECTOR_CACHE_LINE 64
+#endif
+
+/**
+ * Vector that any number of threads can append to and read from without
+ * locks. A push makes sure the buckets it needs exist, reserves its slots
+ * with a compare-and-swap on the size, then fills them. Elements are stored
+ * in buckets of doubling size which are never moved nor freed until the
+ * vector is, so a pointer to an element stays valid and readers never race
+ * with a growth.
+ *
+ * Every slot carries a flag set once its element is written, so readers
+ * only see complete elements
+ */
+typedef struct concurrent_vector {
+
+    /**
+     * Number of slots reserved by the writers
+     */
+    _Alignas(CONCURRENT_VECTOR_CACHE_LINE) atomic_size_t size;
+
+    /**
+     * Buckets, each holding its elements followed by one ready flag per
+     * element. Allocated by the first writer needing them
+     */
+    _Alignas(CONCURRENT_VECTOR_CACHE_LINE) _Atomic(unsigned char*) buckets[CONCURRENT_VECTOR_BUCKETS];
+
+    /**
+     * Size of an element in Bytes
+     */
+    int type_size;
+
+    /**
+     * Allocator of the buckets, must be safe to call from several threads
+     */
+    allocator allocator;
+
+} concurrent_vector;
+
+/**
+ * Returns the bucket holding the element at index
+ */
+int concurrent_vector_bucket(size_t index)
+{
+    unsigned long long q = index / CONCURRENT_VECTOR_FIRST_BUCKET + 1;
+    return 63 - __builtin_clzll(q);
+}
+
+/**
+ * Returns the number of elements of a bucket
+ */
+size_t concurrent_vector_bucket_size(int bucket)
+{
+    return (size_t) CONCURRENT_VECTOR_FIRST_BUCKET << bucket;
+}
+
+/**
+ * Returns the index of the first element of a bucket
+ */
+size_t concurrent_vector_bucket_start(int bucket)
+{
+    return concurrent_vector_bucket_size(bucket) - CONCURRENT_VECTOR_FIRST_BUCKET;
+}
+
+/**
+ * Returns a bucket, allocating it when missing. Writers racing to allocate
+ * the same bucket all try to install theirs and the losers free their copy
+ *
+ * @return bucket, NULL when out of memory
+ */
+unsigned char* concurrent_vector_get_bucket(concurrent_vector* v, int bucket)
+{
+    unsigned char* items = atomic_load_explicit(&v -> buckets[bucket], memory_order_acquire);
+    if (items)
+    {
+        return items;
+    }
+
+    size_t elements = concurrent_vector_bucket_size(bucket);
+    size_t bytes = elements * (v -> type_size + 1);
+    unsigned char* fresh = v -> allocator.alloc(v -> allocator.context, bytes);
+    if (!fresh)
+    {
+        return NULL;
+    }
+    unsigned char zero = 0;
+    set(fresh + elements * v -> type_size, fresh + bytes, &zero, 1);
+    if (atomic_compare_exchange_strong_explicit(&v -> buckets[bucket], &items, fresh,
+                                                memory_order_acq_rel, memory_order_acquire))
+    {
+        return fresh;
+    }
+    v -> allocator.free(v -> allocator.context, fresh, bytes);
+    return items;
+}
+
+/**
+ * Returns the ready flag of the slot at offset inside a bucket
+ */
+atomic_uchar* concurrent_vector_ready(concurrent_vector* v, unsigned char* items, int bucket, size_t offset)
+{
+    return (atomic_uchar*) (items + concurrent_vector_bucket_size(bucket) * v -> type_size + offset);
+}
+
+/**
+ * Initializes an empty concurrent vector drawing its buckets from the given
+ * allocator. Not thread safe
+ *
+ * @param v pointer to the concurrent vector
+ * @param type_size size of an element in Bytes
+ * @param alloc thread safe allocator, NULL for the heap
+ * @return status
+ */
+int concurrent_vector_init_allocator(concurrent_vector* v, int type_size, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!v || type_size <= 0)
+    {
+        return status;
+    }
+    atomic_init(&v -> size, 0);
+    int b;
+    for (b = 0; b < CONCURRENT_VECTOR_BUCKETS; ++b)
+    {
+        atomic_init(&v -> buckets[b], NULL);
+    }
+    v -> type_size = type_size;
+    v -> allocator = alloc ? *alloc : heap_allocator();
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes an empty concurrent vector on the heap. Not thread safe
+ *
+ * @param v pointer to the concurrent vector
+ * @param type_size size of an element in Bytes
+ * @return status
+ */
+int concurrent_vector_init(concurrent_vector* v, int type_size)
+{
+    return concurrent_vector_init_allocator(v, type_size, NULL);
+}
+
+/**
+ * Returns the number of reserved slots. The elements of the latest ones
+ * may still be being written
+ */
+size_t concurrent_vector_size(concurrent_vector* v)
+{
+    return v ? atomic_load_explicit(&v -> size, memory_order_acquire) : 0;
+}
+
+/**
+ * Adds count elements at the end, reserving all of their slots at once.
+ * The elements are contiguous in the index space, not necessarily in memory.
+ * On failure no slot is reserved and the size is unchanged
+ *
+ * @param v pointer to the concurrent vector
+ * @param values contiguous array of count elements
+ * @param count number of elements
+ * @param index receiving the index of the first element, may be NULL
+ * @return status
+ */
+int concurrent_vector_push_batch(concurrent_vector* v, const void* values, size_t count, size_t* index)
+{
+    int status = FAILURE;
+    if (!v || !values || count == 0)
+    {
+        return status;
+    }
+
+    // Reserve the slots only once their buckets exist, so a failure never
+    // leaves reserved slots which will not be written
+    size_t first = atomic_load_explicit(&v -> size, memory_order_relaxed);
+    do
+    {
+        if (first + count < first ||
+            concurrent_vector_bucket(first + count - 1) >= CONCURRENT_VECTOR_BUCKETS)
+        {
+            return status;
+        }
+        int b;
+        for (b = concurrent_vector_bucket(first); b <= concurrent_vector_bucket(first + count - 1); ++b)
+        {
+            if (!concurrent_vector_get_bucket(v, b))
+            {
+                return status;
+            }
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&v -> size, &first, first + count,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    // Fill the reserved slots bucket by bucket
+    const unsigned char* value = values;
+    size_t i = first;
+    while (i < first + count)
+    {
+        int bucket = concurrent_vector_bucket(i);
+        unsigned char* items = atomic_load_explicit(&v -> buckets[bucket], memory_order_acquire);
+        size_t offset = i - concurrent_vector_bucket_start(bucket);
+        size_t n = min(first + count - i, concurrent_vector_bucket_size(bucket) - offset);
+        copy(items + offset * v -> type_size, value, n * v -> type_size);
+        size_t k;
+        for (k = 0; k < n; ++k)
+        {
+            atomic_store_explicit(concurrent_vector_ready(v, items, bucket, offset + k), 1, memory_order_release);
+        }
+        value += n * v -> type_size;
+        i += n;
+    }
+    if (index)
+    {
+        *index = first;
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Adds an element at the end
+ *
+ * @param v pointer to the concurrent vector
+ * @param value to add
+ * @param index receiving the index of the element, may be NULL
+ * @return status
+ */
+int concurrent_vector_push_back(concurrent_vector* v, const void* value, size_t* index)
+{
+    return concurrent_vector_push_batch(v, value, 1, index);
+}
+
+/**
+ * Returns the element at index once it has been written. The pointer stays
+ * valid until the vector is freed
+ *
+ * @param v pointer to the concurrent vector
+ * @param index of the element
+ * @return pointer to the element, NULL when out of bounds or not written yet
+ */
+void* concurrent_vector_at(concurrent_vector* v, size_t index)
+{
+    if (!v || index >= atomic_load_explicit(&v -> size, memory_order_relaxed))
+    {
+        return NULL;
+    }
+    int bucket = concurrent_vector_bucket(index);
+    unsigned char* items = atomic_load_explicit(&v -> buckets[bucket], memory_order_acquire);
+    if (!items)
+    {
+        return NULL;
+    }
+    size_t offset = index - concurrent_vector_bucket_start(bucket);
+    if (!atomic_load_explicit(concurrent_vector_ready(v, items, bucket, offset), memory_order_acquire))
+    {
+        return NULL;
+    }
+    return items + offset * v -> type_size;
+}
+
+/**
+ * Releases every bucket. Not thread safe: no other thread may use the vector
+ *
+ * @param v pointer to the concurrent vector
+ * @return status
+ */
+int concurrent_vector_free(concurrent_vector* v)
+{
+    int status = FAILURE;
+    if (v)
+    {
+        int b;
+        for (b = 0; b < CONCURRENT_VECTOR_BUCKETS; ++b)
+        {
+            unsigned char* items = atomic_load_explicit(&v -> buckets[b], memory_order_relaxed);
+            if (items)
+            {
+                size_t bytes = concurrent_vector_bucket_size(b) * (v -> type_size + 1);
+                v -> allocator.free(v -> allocator.context, items, bytes);
+                atomic_store_explicit(&v -> buckets[b], NULL, memory_order_relaxed);
+            }
+        }
+        atomic_store_explicit(&v -> size, 0, memory_order_relaxed);
+        status = SUCCESS;
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file    concurrent_vector_test.c - Main program for testing the concurrent vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+#include "./concurrent_vector.h"
+
+#define WRITERS 4
+#define ITEMS 250000LL
+#define BATCH 16
+
+concurrent_vector cv;
+atomic_int failures;
+
+void* failing_alloc(void* context, size_t size)
+{
+    (void) context;
+    (void) size;
+    return NULL;
+}
+
+void* writer(void* arg)
+{
+    long long id = *(long long*) arg;
+    long long batch[BATCH];
+    int filled = 0;
+    long long i;
+    for (i = 0; i < ITEMS; ++i)
+    {
+        // Half of the values are pushed one by one, half in batches
+        long long value = id * ITEMS + i;
+        if (i < ITEMS / 2)
+        {
+            atomic_fetch_or(&failures, concurrent_vector_push_back(&cv, &value, NULL));
+        }
+        else
+        {
+            batch[filled++] = value;
+            if (filled == BATCH || i == ITEMS - 1)
+            {
+                atomic_fetch_or(&failures, concurrent_vector_push_batch(&cv, batch, filled, NULL));
+                filled = 0;
+            }
+        }
+    }
+    return NULL;
+}
+
+void* reader(void* arg)
+{
+    (void) arg;
+    // Every element seen must be complete, whatever the writers are doing
+    long long seen = 0;
+    while (seen < WRITERS * ITEMS)
+    {
+        size_t size = concurrent_vector_size(&cv);
+        size_t i;
+        seen = 0;
+        for (i = 0; i < size; ++i)
+        {
+            long long* value = concurrent_vector_at(&cv, i);
+            if (value)
+            {
+                if (*value < 0 || *value >= WRITERS * ITEMS)
+                {
+                    atomic_fetch_or(&failures, FAILURE);
+                }
+                seen++;
+            }
+        }
+    }
+    return NULL;
+}
+
+int main()
+{
+    int status = concurrent_vector_init(&cv, sizeof(long long));
+    printf("Init:                   (status %d)\n", status);
+
+    long long value = 42;
+    size_t index;
+    status = concurrent_vector_push_back(&cv, &value, &index);
+    printf("Push 42 at %zu:           (status %d)\n", index, status);
+    printf("At 0:                        %5lld\n", *(long long*) concurrent_vector_at(&cv, 0));
+    printf("At out of bounds:       (null %d)\n", concurrent_vector_at(&cv, 1) == NULL);
+    concurrent_vector_free(&cv);
+
+    status = concurrent_vector_init(&cv, sizeof(long long));
+    pthread_t threads[WRITERS + 1];
+    long long ids[WRITERS];
+    long long i;
+    for (i = 0; i < WRITERS; ++i)
+    {
+        ids[i] = i;
+        pthread_create(&threads[i], NULL, writer, &ids[i]);
+    }
+    pthread_create(&threads[WRITERS], NULL, reader, NULL);
+    for (i = 0; i <= WRITERS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    printf("%d writers, 1 reader:    (status %d)\n", WRITERS, status | atomic_load(&failures));
+    printf("Size:                      %zu\n", concurrent_vector_size(&cv));
+
+    // Every value must be there exactly once
+    unsigned char* found = calloc(WRITERS * ITEMS, 1);
+    int unique = found != NULL;
+    for (i = 0; unique && i < WRITERS * ITEMS; ++i)
+    {
+        long long element = *(long long*) concurrent_vector_at(&cv, i);
+        unique &= !found[element];
+        found[element] = 1;
+    }
+    free(found);
+    printf("Every value once:       (status %d)\n", !unique);
+    printf("Free:                   (status %d)\n", concurrent_vector_free(&cv));
+
+    allocator exhausted = heap_allocator();
+    exhausted.alloc = failing_alloc;
+    concurrent_vector_init_allocator(&cv, sizeof(long long), &exhausted);
+    i = 42;
+    printf("Push out of memory:     (status %d)\n", concurrent_vector_push_back(&cv, &i, NULL));
+    printf("Size:                            %d\n", (int) concurrent_vector_size(&cv));
+    printf("Free:                   (status %d)\n", concurrent_vector_free(&cv));
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file    parallel_test.c - Main program for testing the parallel algorithms over the vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./vector_parallel.h"
+
+void square(void* element, void* context)
+{
+    (void) context;
+    long long* value = element;
+    *value = *value * *value;
+}
+
+void add(void* accumulator, const void* element)
+{
+    *(long long*) accumulator += *(const long long*) element;
+}
+
+int main()
+{
+    thread_pool p;
+    int status = thread_pool_init(&p, 0);
+    printf("Thread pool init:       (status %d)\n", status);
+    printf("Threads:                     %5d\n", thread_pool_threads(&p));
+
+    vector v;
+    vector_init_packed(&v, sizeof(long long), 0, 0);
+    long long n = 1000000;
+    long long i;
+    for (i = 0; i < n; ++i)
+    {
+        long long value = (i * 7919) % n;
+        v.push_back(&v, &value);
+    }
+
+    long long value = 4242;
+    printf("Find %lld Index:          %8d\n", value, parallel_find(&p, &v, &value));
+    printf("Count value %lld:         %8d\n", value, parallel_count(&p, &v, &value));
+
+    long long sum = 0;
+    long long zero = 0;
+    status = parallel_reduce(&p, &v, &zero, &sum, add, add, sizeof(sum));
+    printf("Reduce sum:     %lld (status %d)\n", sum, status);
+
+    status = parallel_sort(&p, &v, compare_long_long);
+    int sorted = true;
+    for (i = 0; i < n; ++i)
+    {
+        sorted &= (*(long long*) v.at(&v, (int) i) == i);
+    }
+    printf("Sort:                   (status %d)\n", status);
+    printf("Sorted:                 (status %d)\n", !sorted);
+
+    status = parallel_transform(&p, &v, square, NULL);
+    printf("Transform square:       (status %d)\n", status);
+    printf("v[%d] = %lld\n", 1000, *(long long*) v.at(&v, 1000));
+
+    value = 1;
+    status = parallel_fill(&p, &v, &value);
+    printf("Fill %lld:                (status %d)\n", value, status);
+    printf("Count value %lld:         %8d\n", value, parallel_count(&p, &v, &value));
+
+    v.free(&v);
+    thread_pool_free(&p);
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+/**
+ * @file    thread_pool.h - Fork-join pool of worker threads
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../utils.h"
+
+#define THREAD_POOL_MAX_THREADS 256
+
+/**
+ * Task run by the pool
+ *
+ * @param args shared by all the tasks of a job
+ * @param task index of the task, between 0 and the number of tasks
+ */
+typedef void (*thread_task)(void* args, int task);
+
+/**
+ * Pool of worker threads running jobs made of independent tasks. The thread
+ * submitting a job takes part in it and returns once every task is done
+ */
+typedef struct thread_pool {
+
+    /**
+     * Worker threads
+     */
+    pthread_t* threads;
+
+    /**
+     * Number of worker threads
+     */
+    int size;
+
+    /**
+     * Protects the fields below next
+     */
+    pthread_mutex_t lock;
+
+    /**
+     * Signaled when a job is submitted or the pool is stopped
+     */
+    pthread_cond_t wake;
+
+    /**
+     * Signaled when a job may be complete
+     */
+    pthread_cond_t done;
+
+    /**
+     * Index of the next task to run
+     */
+    atomic_int next;
+
+    /**
+     * Task of the current job
+     */
+    thread_task task;
+
+    /**
+     * Arguments of the current job
+     */
+    void* args;
+
+    /**
+     * Number of tasks of the current job
+     */
+    int tasks;
+
+    /**
+     * Number of tasks of the current job already completed
+     */
+    int finished;
+
+    /**
+     * Workers currently running tasks of the current job
+     */
+    int active;
+
+    /**
+     * Incremented on every job
+     */
+    unsigned long generation;
+
+    /**
+     * Set when the workers have to exit
+     */
+    int stop;
+
+} thread_pool;
+
+/**
+ * Runs tasks of the current job until none is left
+ *
+ * @return number of tasks completed
+ */
+int thread_pool_drain(thread_pool* p, thread_task task, void* args, int tasks)
+{
+    int completed = 0;
+    int i;
+    while ((i = atomic_fetch_add(&p -> next, 1)) < tasks)
+    {
+        task(args, i);
+        completed++;
+    }
+    return completed;
+}
+
+/**
+ * Body of a worker thread
+ */
+void* thread_pool_worker(void* arg)
+{
+    thread_pool* p = arg;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&p -> lock);
+    while (true)
+    {
+        while (p -> generation == seen && !p -> stop)
+        {
+            pthread_cond_wait(&p -> wake, &p -> lock);
+        }
+        if (p -> stop)
+        {
+            break;
+        }
+
+        seen = p -> generation;
+        thread_task task = p -> task;
+        void* args = p -> args;
+        int tasks = p -> tasks;
+        p -> active++;
+        pthread_mutex_unlock(&p -> lock);
+
+        int completed = thread_pool_drain(p, task, args, tasks);
+
+        pthread_mutex_lock(&p -> lock);
+        p -> finished += completed;
+        p -> active--;
+        if (p -> active == 0 || p -> finished == p -> tasks)
+        {
+            pthread_cond_broadcast(&p -> done);
+        }
+    }
+    pthread_mutex_unlock(&p -> lock);
+    return NULL;
+}
+
+/**
+ * Returns the number of online processors
+ */
+int thread_pool_processors()
+{
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0 ? (int) processors : 1;
+}
+
+/**
+ * Stops and joins the worker threads
+ *
+ * @param p pointer to the pool
+ * @return status
+ */
+int thread_pool_free(thread_pool* p)
+{
+    int status = FAILURE;
+    if (p && p -> threads)
+    {
+        pthread_mutex_lock(&p -> lock);
+        p -> stop = true;
+        pthread_cond_broadcast(&p -> wake);
+        pthread_mutex_unlock(&p -> lock);
+
+        int i;
+        for (i = 0; i < p -> size; ++i)
+        {
+            pthread_join(p -> threads[i], NULL);
+        }
+        free(p -> threads);
+        p -> threads = NULL;
+        p -> size = 0;
+        pthread_mutex_destroy(&p -> lock);
+        pthread_cond_destroy(&p -> wake);
+        pthread_cond_destroy(&p -> done);
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Starts the worker threads. If any of them cannot be started, the ones
+ * already running are stopped and the pool is released
+ *
+ * @param p pointer to the pool
+ * @param threads total number of threads running jobs, the caller included.
+ *                Zero or less means one per processor
+ * @return status
+ */
+int thread_pool_init(thread_pool* p, int threads)
+{
+    int status = FAILURE;
+    if (!p)
+    {
+        return status;
+    }
+
+    if (threads <= 0)
+    {
+        threads = thread_pool_processors();
+    }
+    threads = min(threads, THREAD_POOL_MAX_THREADS);
+
+    p -> size = 0;
+    p -> threads = malloc(sizeof(pthread_t) * threads);
+    if (!p -> threads)
+    {
+        return status;
+    }
+    pthread_mutex_init(&p -> lock, NULL);
+    pthread_cond_init(&p -> wake, NULL);
+    pthread_cond_init(&p -> done, NULL);
+    atomic_init(&p -> next, 0);
+    p -> task = NULL;
+    p -> args = NULL;
+    p -> tasks = 0;
+    p -> finished = 0;
+    p -> active = 0;
+    p -> generation = 0;
+    p -> stop = false;
+
+    status = SUCCESS;
+    int i;
+    for (i = 0; i < threads - 1 && status == SUCCESS; ++i)
+    {
+        if (pthread_create(&p -> threads[i], NULL, thread_pool_worker, p) == 0)
+        {
+            p -> size++;
+        }
+        else
+        {
+            status = FAILURE;
+        }
+    }
+    if (status != SUCCESS)
+    {
+        // Stop the workers already started, the caller won't free the pool
+        thread_pool_free(p);
+    }
+    return status;
+}
+
+/**
+ * Returns the number of threads running a job, the caller included
+ *
+ * @param p pointer to the pool
+ * @return number of threads
+ */
+int thread_pool_threads(thread_pool* p)
+{
+    return p ? p -> size + 1 : VALUE_ERROR;
+}
+
+/**
+ * Runs task(args, i) for every i in [0, tasks) on the pool and waits for
+ * all of them to complete
+ *
+ * @param p pointer to the pool
+ * @param task to run
+ * @param args passed to every task
+ * @param tasks number of tasks
+ * @return status
+ */
+int thread_pool_run(thread_pool* p, thread_task task, void* args, int tasks)
+{
+    int status = FAILURE;
+    if (!p || !task || tasks < 0)
+    {
+        return status;
+    }
+
+    // A worker waking up late may still be inside the previous job, which
+    // must be over before next is reset
+    pthread_mutex_lock(&p -> lock);
+    while (p -> active > 0)
+    {
+        pthread_cond_wait(&p -> done, &p -> lock);
+    }
+    p -> task = task;
+    p -> args = args;
+    p -> tasks = tasks;
+    p -> finished = 0;
+    atomic_store(&p -> next, 0);
+    p -> generation++;
+    pthread_cond_broadcast(&p -> wake);
+    pthread_mutex_unlock(&p -> lock);
+
+    int completed = thread_pool_drain(p, task, args, tasks);
+
+    pthread_mutex_lock(&p -> lock);
+    p -> finished += completed;
+    while (p -> finished < p -> tasks)
+    {
+        pthread_cond_wait(&p -> done, &p -> lock);
+    }
+    pthread_mutex_unlock(&p -> lock);
+
+    status = SUCCESS;
+    return status;
+}
+
+#endif
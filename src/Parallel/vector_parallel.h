@@ -0,0 +1,499 @@
+/**
+ * @file    vector_parallel.h - Multi-threaded algorithms over the vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_PARALLEL_H
+#define VECTOR_PARALLEL_H
+
+#pragma once
+
+#include "../Vector/vector.h"
+#include "./thread_pool.h"
+
+/**
+ * Vectors smaller than this are processed by the calling thread alone
+ */
+#define PARALLEL_MIN_ELEMENTS 16384
+
+/**
+ * Number of chunks each thread gets, to balance uneven chunks
+ */
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+/**
+ * Elements find scans between two checks of the cancellation flag
+ */
+#define PARALLEL_FIND_STRIDE 1024
+
+/**
+ * Splitting of a vector into contiguous chunks, shared by the tasks
+ */
+typedef struct parallel_job {
+
+    /**
+     * Vector being processed
+     */
+    vector* v;
+
+    /**
+     * Number of elements
+     */
+    int size;
+
+    /**
+     * Number of chunks
+     */
+    int chunks;
+
+    /**
+     * Value the elements are compared with or set to
+     */
+    const void* value;
+
+    /**
+     * Per-chunk results or scratch space, depending on the algorithm
+     */
+    void* results;
+
+    /**
+     * Function applied to the elements
+     */
+    void* function;
+
+    /**
+     * User context passed to function
+     */
+    void* context;
+
+    /**
+     * Smallest index found so far by find
+     */
+    atomic_int found;
+
+} parallel_job;
+
+/**
+ * Number of chunks to split size elements into
+ */
+int parallel_chunks(thread_pool* p, int size)
+{
+    int chunks = 1;
+    if (size >= PARALLEL_MIN_ELEMENTS)
+    {
+        chunks = thread_pool_threads(p) * PARALLEL_CHUNKS_PER_THREAD;
+        chunks = min(chunks, size / (PARALLEL_MIN_ELEMENTS / PARALLEL_CHUNKS_PER_THREAD));
+        chunks = max(chunks, 1);
+    }
+    return chunks;
+}
+
+/**
+ * First index of a chunk. Chunk number chunks gives the size
+ */
+int chunk_start(parallel_job* job, int chunk)
+{
+    return (int) ((long long) job -> size * chunk / job -> chunks);
+}
+
+/**
+ * Prepares a job over the whole vector
+ */
+void parallel_job_init(parallel_job* job, thread_pool* p, vector* v, const void* value)
+{
+    job -> v = v;
+    job -> size = v -> size(v);
+    job -> chunks = parallel_chunks(p, job -> size);
+    job -> value = value;
+    job -> results = NULL;
+    job -> function = NULL;
+    job -> context = NULL;
+    atomic_init(&job -> found, INT_MAX);
+}
+
+/**
+ * Copies the value into every element of a chunk
+ */
+void parallel_fill_task(void* args, int chunk)
+{
+    parallel_job* job = args;
+    int type_size = job -> v -> get_type_size(job -> v);
+    int end = chunk_start(job, chunk + 1);
+    int i;
+    for (i = chunk_start(job, chunk); i < end; ++i)
+    {
+        copy(item_address(job -> v, i), job -> value, type_size);
+    }
+}
+
+/**
+ * Fills up the vector with the given value using every thread of the pool
+ *
+ * @param p pointer to the thread pool
+ * @param v pointer to the vector
+ * @param value to fill the vector with
+ * @return status
+ */
+int parallel_fill(thread_pool* p, vector* v, const void* value)
+{
+    int status = FAILURE;
+    if (p && v && value && v -> members.items)
+    {
+        parallel_job job;
+        parallel_job_init(&job, p, v, value);
+        status = thread_pool_run(p, parallel_fill_task, &job, job.chunks);
+    }
+    return status;
+}
+
+/**
+ * Counts the occurrences of the value in a chunk
+ */
+void parallel_count_task(void* args, int chunk)
+{
+    parallel_job* job = args;
+    int type_size = job -> v -> get_type_size(job -> v);
+    int end = chunk_start(job, chunk + 1);
+    int count = 0;
+    int i;
+    for (i = chunk_start(job, chunk); i < end; ++i)
+    {
+        count += (compare(item_address(job -> v, i), job -> value, type_size) == SUCCESS);
+    }
+    ((int*) job -> results)[chunk] = count;
+}
+
+/**
+ * Counts the number of occurrences of a given value using every thread of
+ * the pool
+ *
+ * @param p pointer to the thread pool
+ * @param v pointer to the vector
+ * @param value to count
+ * @return number of occurrences of value
+ */
+int parallel_count(thread_pool* p, vector* v, const void* value)
+{
+    int count = VALUE_ERROR;
+    if (p && v && value && v -> members.items)
+    {
+        parallel_job job;
+        parallel_job_init(&job, p, v, value);
+        int counts[THREAD_POOL_MAX_THREADS * PARALLEL_CHUNKS_PER_THREAD];
+        job.results = counts;
+        if (thread_pool_run(p, parallel_count_task, &job, job.chunks) == SUCCESS)
+        {
+            count = 0;
+            int i;
+            for (i = 0; i < job.chunks; ++i)
+            {
+                count += counts[i];
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Looks for the first occurrence of the value in a chunk
+ */
+void parallel_find_task(void* args, int chunk)
+{
+    parallel_job* job = args;
+    int type_size = job -> v -> get_type_size(job -> v);
+    int end = chunk_start(job, chunk + 1);
+    int i = chunk_start(job, chunk);
+    while (i < end)
+    {
+        // Stops as soon as an earlier chunk found the value
+        if (i > atomic_load_explicit(&job -> found, memory_order_relaxed))
+        {
+            return;
+        }
+
+        int stride_end = min(end, i + PARALLEL_FIND_STRIDE);
+        for (; i < stride_end; ++i)
+        {
+            if (compare(item_address(job -> v, i), job -> value, type_size) == SUCCESS)
+            {
+                int found = atomic_load(&job -> found);
+                while (i < found && !atomic_compare_exchange_weak(&job -> found, &found, i));
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Finds the first occurrence of a value using every thread of the pool.
+ * Chunks after the first match found stop scanning
+ *
+ * @param p pointer to the thread pool
+ * @param v pointer to the vector
+ * @param value to find
+ * @return index of the first value
+ */
+int parallel_find(thread_pool* p, vector* v, const void* value)
+{
+    int index = VALUE_ERROR;
+    if (p && v && value && v -> members.items)
+    {
+        parallel_job job;
+        parallel_job_init(&job, p, v, value);
+        if (thread_pool_run(p, parallel_find_task, &job, job.chunks) == SUCCESS)
+        {
+            int found = atomic_load(&job.found);
+            index = (found == INT_MAX) ? VALUE_ERROR : found;
+        }
+    }
+    return index;
+}
+
+/**
+ * Applies the function to every element of a chunk
+ */
+void parallel_transform_task(void* args, int chunk)
+{
+    parallel_job* job = args;
+    void (*function)(void*, void*) = (void (*)(void*, void*)) job -> function;
+    int end = chunk_start(job, chunk + 1);
+    int i;
+    for (i = chunk_start(job, chunk); i < end; ++i)
+    {
+        function(item_address(job -> v, i), job -> context);
+    }
+}
+
+/**
+ * Applies a function to every element in place using every thread of the
+ * pool. The function is called concurrently on different elements
+ *
+ * @param p pointer to the thread pool
+ * @param v pointer to the vector
+ * @param function applied to every element, with the user context
+ * @param context passed to function
+ * @return status
+ */
+int parallel_transform(thread_pool* p, vector* v, void (*function)(void* element, void* context), void* context)
+{
+    int status = FAILURE;
+    if (p && v && function && v -> members.items)
+    {
+        parallel_job job;
+        parallel_job_init(&job, p, v, NULL);
+        job.function = (void*) function;
+        job.context = context;
+        status = thread_pool_run(p, parallel_transform_task, &job, job.chunks);
+    }
+    return status;
+}
+
+/**
+ * Functions of a reduction
+ */
+typedef struct parallel_reducer {
+
+    /**
+     * Folds an element into an accumulator
+     */
+    void (*accumulate)(void* accumulator, const void* element);
+
+    /**
+     * Folds the accumulator of a later chunk into the one of an earlier chunk
+     */
+    void (*combine)(void* accumulator, const void* other);
+
+    /**
+     * Size of an accumulator in bytes
+     */
+    int result_size;
+
+} parallel_reducer;
+
+/**
+ * Reduces a chunk into its own accumulator
+ */
+void parallel_reduce_task(void* args, int chunk)
+{
+    parallel_job* job = args;
+    const parallel_reducer* reducer = job -> function;
+    unsigned char* accumulator = (unsigned char*) job -> results + (size_t) chunk * reducer -> result_size;
+    copy(accumulator, job -> value, reducer -> result_size);
+    int end = chunk_start(job, chunk + 1);
+    int i;
+    for (i = chunk_start(job, chunk); i < end; ++i)
+    {
+        reducer -> accumulate(accumulator, item_address(job -> v, i));
+    }
+}
+
+/**
+ * Reduces the vector to a single value using every thread of the pool.
+ * Every chunk starts from identity and folds its elements in order, then
+ * the chunk results are combined in order, so accumulate and combine only
+ * need to be associative
+ *
+ * @param p pointer to the thread pool
+ * @param v pointer to the vector
+ * @param identity initial value of every accumulator
+ * @param result where to write the reduced value
+ * @param accumulate folds an element into an accumulator
+ * @param combine folds an accumulator into another
+ * @param result_size size of identity and result in bytes
+ * @return status
+ */
+int parallel_reduce(thread_pool* p, vector* v, const void* identity, void* result,
+                    void (*accumulate)(void* accumulator, const void* element),
+                    void (*combine)(void* accumulator, const void* other), int result_size)
+{
+    int status = FAILURE;
+    if (!p || !v || !identity || !result || !accumulate || !combine
+        || result_size <= 0 || !v -> members.items)
+    {
+        return status;
+    }
+
+    parallel_job job;
+    parallel_job_init(&job, p, v, identity);
+    parallel_reducer reducer = { accumulate, combine, result_size };
+    job.function = &reducer;
+    job.results = malloc((size_t) job.chunks * result_size);
+    if (!job.results)
+    {
+        return status;
+    }
+
+    status = thread_pool_run(p, parallel_reduce_task, &job, job.chunks);
+    if (status == SUCCESS)
+    {
+        unsigned char* accumulators = job.results;
+        int i;
+        for (i = 1; i < job.chunks; ++i)
+        {
+            combine(accumulators, accumulators + (size_t) i * result_size);
+        }
+        copy(result, accumulators, result_size);
+    }
+    free(job.results);
+    return status;
+}
+
+/**
+ * State of a parallel merge sort
+ */
+typedef struct parallel_sort_job {
+
+    /**
+     * Shared chunking of the vector
+     */
+    parallel_job* job;
+
+    /**
+     * Buffer holding the sorted runs
+     */
+    unsigned char* src;
+
+    /**
+     * Buffer receiving the merged runs
+     */
+    unsigned char* dst;
+
+    /**
+     * Chunks per run in the current merge round
+     */
+    int width;
+
+} parallel_sort_job;
+
+/**
+ * Merge sorts a chunk in place
+ */
+void parallel_sort_chunk_task(void* args, int chunk)
+{
+    parallel_sort_job* sort = args;
+    parallel_job* job = sort -> job;
+    size_t item_size = job -> v -> get_item_size(job -> v);
+    size_t start = chunk_start(job, chunk);
+    size_t n = chunk_start(job, chunk + 1) - start;
+    merge_sort(sort -> src + start * item_size, n, item_size, (comparator) job -> function,
+               sort -> dst + start * item_size);
+}
+
+/**
+ * Merges two adjacent sorted runs of chunks into the other buffer
+ */
+void parallel_sort_merge_task(void* args, int pair)
+{
+    parallel_sort_job* sort = args;
+    parallel_job* job = sort -> job;
+    size_t item_size = job -> v -> get_item_size(job -> v);
+    int first = pair * 2 * sort -> width;
+    size_t left = chunk_start(job, first);
+    size_t middle = chunk_start(job, min(first + sort -> width, job -> chunks));
+    size_t right = chunk_start(job, min(first + 2 * sort -> width, job -> chunks));
+    merge(sort -> dst + left * item_size, sort -> src + left * item_size, middle - left,
+          sort -> src + middle * item_size, right - middle, item_size, (comparator) job -> function);
+}
+
+/**
+ * Sorts the vector with a parallel merge sort: every chunk is merge sorted
+ * by one thread, then sorted runs are merged pairwise in parallel rounds.
+ * Stable. Needs a scratch buffer as big as the elements, taken from the
+ * allocator of the vector
+ *
+ * @param p pointer to the thread pool
+ * @param v pointer to the vector
+ * @param cmp comparator
+ * @return status
+ */
+int parallel_sort(thread_pool* p, vector* v, comparator cmp)
+{
+    int status = FAILURE;
+    if (!p || !v || !cmp || !v -> members.items)
+    {
+        return status;
+    }
+
+    parallel_job job;
+    parallel_job_init(&job, p, v, NULL);
+    if (job.chunks == 1)
+    {
+        return v -> stable_sort(v, cmp);
+    }
+
+    size_t bytes = (size_t) job.size * v -> get_item_size(v);
+    allocator* a = &v -> members.allocator;
+    unsigned char* scratch = a -> alloc(a -> context, bytes);
+    if (!scratch)
+    {
+        return status;
+    }
+
+    job.function = (void*) cmp;
+    parallel_sort_job sort = { &job, v -> begin(v), scratch, 0 };
+    status = thread_pool_run(p, parallel_sort_chunk_task, &sort, job.chunks);
+
+    int width;
+    for (width = 1; width < job.chunks && status == SUCCESS; width *= 2)
+    {
+        sort.width = width;
+        int pairs = (job.chunks + 2 * width - 1) / (2 * width);
+        status = thread_pool_run(p, parallel_sort_merge_task, &sort, pairs);
+        unsigned char* temp = sort.src;
+        sort.src = sort.dst;
+        sort.dst = temp;
+    }
+
+    if (status == SUCCESS && sort.src != (unsigned char*) v -> begin(v))
+    {
+        copy(v -> begin(v), sort.src, bytes);
+    }
+    a -> free(a -> context, scratch, bytes);
+    return status;
+}
+
+#endif
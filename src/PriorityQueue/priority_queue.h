@@ -0,0 +1,499 @@
+/**
+ * @file    priority_queue.h - Binary and 4-ary heaps over vector storage
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#pragma once
+
+#include "../Vector/vector.h"
+
+#define PRIORITY_QUEUE_BINARY 2
+#define PRIORITY_QUEUE_QUATERNARY 4
+
+/**
+ * Handle of an element which has left the queue
+ */
+#define PRIORITY_QUEUE_NO_POSITION (-1)
+
+/**
+ * Priority queue keeping the element which compares first on top. Elements
+ * are stored packed in a vector laid out as an implicit heap where every
+ * node has arity children: a 4-ary heap is half as deep as a binary one and
+ * the children of a node share a cache line for small elements.
+ *
+ * Every element gets a handle when pushed, valid until the element leaves
+ * the queue, which allows to change its priority or remove it later on
+ */
+typedef struct priority_queue {
+
+    /**
+     * Elements in heap order
+     */
+    vector items;
+
+    /**
+     * Handle of the element at every heap position
+     */
+    vector handles;
+
+    /**
+     * Heap position of the element of every handle,
+     * PRIORITY_QUEUE_NO_POSITION when the handle is not in use
+     */
+    vector positions;
+
+    /**
+     * Handles released by elements which left the queue
+     */
+    vector free_handles;
+
+    /**
+     * Orders the elements: the smallest one is on top
+     */
+    comparator cmp;
+
+    /**
+     * Number of children of every node
+     */
+    int arity;
+
+    /**
+     * Holds the element being moved along the heap
+     */
+    unsigned char* scratch;
+
+} priority_queue;
+
+/**
+ * Returns the handle of the element at a heap position
+ */
+int* pq_handle(priority_queue* q, int position)
+{
+    return item_address(&q -> handles, position);
+}
+
+/**
+ * Returns the heap position of the element of a handle
+ */
+int* pq_position(priority_queue* q, int handle)
+{
+    return item_address(&q -> positions, handle);
+}
+
+/**
+ * Stores the element held in scratch, whose handle is given, at a position
+ */
+void pq_place(priority_queue* q, int position, int handle)
+{
+    copy(item_address(&q -> items, position), q -> scratch, q -> items.members.type_size);
+    *pq_handle(q, position) = handle;
+    *pq_position(q, handle) = position;
+}
+
+/**
+ * Moves the element at from, with its handle, to the position to
+ */
+void pq_move(priority_queue* q, int to, int from)
+{
+    copy(item_address(&q -> items, to), item_address(&q -> items, from), q -> items.members.type_size);
+    int handle = *pq_handle(q, from);
+    *pq_handle(q, to) = handle;
+    *pq_position(q, handle) = to;
+}
+
+/**
+ * Moves the element at position towards the root while it compares before
+ * its parent. Parents are shifted down into the hole instead of swapping
+ *
+ * @return final position of the element
+ */
+int pq_sift_up(priority_queue* q, int position)
+{
+    int handle = *pq_handle(q, position);
+    copy(q -> scratch, item_address(&q -> items, position), q -> items.members.type_size);
+    while (position > 0)
+    {
+        int parent = (position - 1) / q -> arity;
+        if (q -> cmp(q -> scratch, item_address(&q -> items, parent)) >= 0)
+        {
+            break;
+        }
+        pq_move(q, position, parent);
+        position = parent;
+    }
+    pq_place(q, position, handle);
+    return position;
+}
+
+/**
+ * Moves the element at position towards the leaves while one of its
+ * children compares before it. Children are shifted up into the hole
+ *
+ * @return final position of the element
+ */
+int pq_sift_down(priority_queue* q, int position)
+{
+    int size = q -> items.size(&q -> items);
+    int handle = *pq_handle(q, position);
+    copy(q -> scratch, item_address(&q -> items, position), q -> items.members.type_size);
+    while (true)
+    {
+        int first = position * q -> arity + 1;
+        if (first >= size)
+        {
+            break;
+        }
+        int last = min(first + q -> arity, size);
+        int best = first;
+        int child;
+        for (child = first + 1; child < last; ++child)
+        {
+            if (q -> cmp(item_address(&q -> items, child), item_address(&q -> items, best)) < 0)
+            {
+                best = child;
+            }
+        }
+        if (q -> cmp(item_address(&q -> items, best), q -> scratch) >= 0)
+        {
+            break;
+        }
+        pq_move(q, position, best);
+        position = best;
+    }
+    pq_place(q, position, handle);
+    return position;
+}
+
+/**
+ * Initializes an empty priority queue drawing its memory from the given
+ * allocator
+ *
+ * @param q pointer to the priority queue
+ * @param type_size size of an element in Bytes
+ * @param arity PRIORITY_QUEUE_BINARY or PRIORITY_QUEUE_QUATERNARY
+ * @param cmp orders the elements, the smallest one being on top
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int priority_queue_init_allocator(priority_queue* q, int type_size, int arity, comparator cmp, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!q || type_size <= 0 || !cmp || (arity != PRIORITY_QUEUE_BINARY && arity != PRIORITY_QUEUE_QUATERNARY))
+    {
+        return status;
+    }
+
+    vector_init_packed_allocator(&q -> items, type_size, 0, 0, alloc);
+    vector_init_packed_allocator(&q -> handles, sizeof(int), 0, 0, alloc);
+    vector_init_packed_allocator(&q -> positions, sizeof(int), 0, 0, alloc);
+    vector_init_packed_allocator(&q -> free_handles, sizeof(int), 0, 0, alloc);
+    q -> cmp = cmp;
+    q -> arity = arity;
+    q -> scratch = q -> items.members.allocator.alloc(q -> items.members.allocator.context, type_size);
+    if (q -> scratch)
+    {
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Initializes an empty priority queue on the heap
+ *
+ * @param q pointer to the priority queue
+ * @param type_size size of an element in Bytes
+ * @param arity PRIORITY_QUEUE_BINARY or PRIORITY_QUEUE_QUATERNARY
+ * @param cmp orders the elements, the smallest one being on top
+ * @return status
+ */
+int priority_queue_init(priority_queue* q, int type_size, int arity, comparator cmp)
+{
+    return priority_queue_init_allocator(q, type_size, arity, cmp, NULL);
+}
+
+/**
+ * Returns the number of elements
+ */
+int priority_queue_size(priority_queue* q)
+{
+    return q ? q -> items.size(&q -> items) : VALUE_ERROR;
+}
+
+/**
+ * Checks if the priority queue is empty
+ */
+int priority_queue_empty(priority_queue* q)
+{
+    return q ? q -> items.empty(&q -> items) : VALUE_ERROR;
+}
+
+/**
+ * Returns the element on top, NULL when empty
+ *
+ * @param q pointer to the priority queue
+ * @return pointer to the smallest element
+ */
+void* priority_queue_top(priority_queue* q)
+{
+    if (!q || q -> items.empty(&q -> items))
+    {
+        return NULL;
+    }
+    return item_address(&q -> items, 0);
+}
+
+/**
+ * Adds an element
+ *
+ * @param q pointer to the priority queue
+ * @param value to add
+ * @param handle receiving the handle of the element, may be NULL
+ * @return status
+ */
+int priority_queue_push(priority_queue* q, const void* value, int* handle)
+{
+    int status = FAILURE;
+    if (!q || !value)
+    {
+        return status;
+    }
+
+    int id;
+    if (!q -> free_handles.empty(&q -> free_handles))
+    {
+        id = *(int*) q -> free_handles.pop_back(&q -> free_handles);
+    }
+    else
+    {
+        id = q -> positions.size(&q -> positions);
+        int none = PRIORITY_QUEUE_NO_POSITION;
+        if (q -> positions.push_back(&q -> positions, &none) != SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    int position = q -> items.size(&q -> items);
+    status = q -> items.push_back(&q -> items, value);
+    if (status == SUCCESS)
+    {
+        status = q -> handles.push_back(&q -> handles, &id);
+        if (status != SUCCESS)
+        {
+            q -> items.pop_back(&q -> items);
+        }
+    }
+    if (status != SUCCESS)
+    {
+        q -> free_handles.push_back(&q -> free_handles, &id);
+        return status;
+    }
+
+    *pq_position(q, id) = position;
+    pq_sift_up(q, position);
+    if (handle)
+    {
+        *handle = id;
+    }
+    return status;
+}
+
+/**
+ * Removes the element of a handle, which becomes free for later pushes
+ *
+ * @param q pointer to the priority queue
+ * @param handle of the element to remove
+ * @param value receiving the removed element, may be NULL
+ * @return status
+ */
+int priority_queue_erase(priority_queue* q, int handle, void* value)
+{
+    int status = FAILURE;
+    if (!q || handle < 0 || handle >= q -> positions.size(&q -> positions))
+    {
+        return status;
+    }
+    int position = *pq_position(q, handle);
+    if (position == PRIORITY_QUEUE_NO_POSITION)
+    {
+        return status;
+    }
+
+    if (value)
+    {
+        copy(value, item_address(&q -> items, position), q -> items.members.type_size);
+    }
+    *pq_position(q, handle) = PRIORITY_QUEUE_NO_POSITION;
+    q -> free_handles.push_back(&q -> free_handles, &handle);
+
+    // The last element fills the hole and is moved in whichever direction it belongs
+    int last = q -> items.size(&q -> items) - 1;
+    if (position != last)
+    {
+        pq_move(q, position, last);
+    }
+    q -> items.pop_back(&q -> items);
+    q -> handles.pop_back(&q -> handles);
+    if (position != last && pq_sift_up(q, position) == position)
+    {
+        pq_sift_down(q, position);
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Removes the element on top
+ *
+ * @param q pointer to the priority queue
+ * @param value receiving the removed element, may be NULL
+ * @return status
+ */
+int priority_queue_pop(priority_queue* q, void* value)
+{
+    if (!q || q -> items.empty(&q -> items))
+    {
+        return FAILURE;
+    }
+    return priority_queue_erase(q, *pq_handle(q, 0), value);
+}
+
+/**
+ * Changes the value of an element, moving it up when it now compares before
+ * (decrease-key) or down when it compares after
+ *
+ * @param q pointer to the priority queue
+ * @param handle of the element to change
+ * @param value new value of the element
+ * @return status
+ */
+int priority_queue_update(priority_queue* q, int handle, const void* value)
+{
+    int status = FAILURE;
+    if (!q || !value || handle < 0 || handle >= q -> positions.size(&q -> positions))
+    {
+        return status;
+    }
+    int position = *pq_position(q, handle);
+    if (position == PRIORITY_QUEUE_NO_POSITION)
+    {
+        return status;
+    }
+
+    copy(item_address(&q -> items, position), value, q -> items.members.type_size);
+    if (pq_sift_up(q, position) == position)
+    {
+        pq_sift_down(q, position);
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Returns the element of a handle, NULL when it is not in the queue
+ *
+ * @param q pointer to the priority queue
+ * @param handle of the element
+ * @return pointer to the element
+ */
+void* priority_queue_get(priority_queue* q, int handle)
+{
+    if (!q || handle < 0 || handle >= q -> positions.size(&q -> positions))
+    {
+        return NULL;
+    }
+    int position = *pq_position(q, handle);
+    return position == PRIORITY_QUEUE_NO_POSITION ? NULL : item_address(&q -> items, position);
+}
+
+/**
+ * Replaces the content of the queue with the elements of a vector in O(n),
+ * sifting down every inner node from the last one. The element at index i
+ * of the vector gets handle i
+ *
+ * @param q pointer to the priority queue
+ * @param v vector holding elements of the same type size
+ * @return status
+ */
+int priority_queue_heapify(priority_queue* q, vector* v)
+{
+    int status = FAILURE;
+    if (!q || !v || v -> get_type_size(v) != q -> items.members.type_size)
+    {
+        return status;
+    }
+
+    int size = v -> size(v);
+    int type_size = q -> items.members.type_size;
+    status = q -> items.resize(&q -> items, size);
+    status |= q -> handles.resize(&q -> handles, size);
+    status |= q -> positions.resize(&q -> positions, size);
+    if (status != SUCCESS)
+    {
+        return status;
+    }
+    q -> free_handles.resize(&q -> free_handles, 0);
+
+    int i;
+    for (i = 0; i < size; ++i)
+    {
+        copy(item_address(&q -> items, i), item_address(v, i), type_size);
+        *pq_handle(q, i) = i;
+        *pq_position(q, i) = i;
+    }
+    for (i = (size - 2) / q -> arity; i >= 0 && size > 1; --i)
+    {
+        pq_sift_down(q, i);
+    }
+    return status;
+}
+
+/**
+ * Removes every element, releasing all the handles
+ *
+ * @param q pointer to the priority queue
+ * @return status
+ */
+int priority_queue_clear(priority_queue* q)
+{
+    int status = FAILURE;
+    if (q)
+    {
+        status = q -> items.resize(&q -> items, 0);
+        status |= q -> handles.resize(&q -> handles, 0);
+        status |= q -> positions.resize(&q -> positions, 0);
+        status |= q -> free_handles.resize(&q -> free_handles, 0);
+    }
+    return status;
+}
+
+/**
+ * Releases the storage of the priority queue
+ *
+ * @param q pointer to the priority queue
+ * @return status
+ */
+int priority_queue_free(priority_queue* q)
+{
+    int status = FAILURE;
+    if (q && q -> scratch)
+    {
+        q -> items.members.allocator.free(q -> items.members.allocator.context, q -> scratch,
+                                          q -> items.members.type_size);
+        q -> scratch = NULL;
+        status = q -> items.free(&q -> items);
+        status |= q -> handles.free(&q -> handles);
+        status |= q -> positions.free(&q -> positions);
+        status |= q -> free_handles.free(&q -> free_handles);
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file    priority_queue_test.c - Main program for testing the priority queue
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./priority_queue.h"
+
+int main()
+{
+    priority_queue q;
+    int status = priority_queue_init(&q, sizeof(int), PRIORITY_QUEUE_QUATERNARY, compare_int);
+    printf("Init 4-ary:             (status %d)\n", status);
+
+    int values[] = { 42, 7, 19, 3, 88, 61, 25 };
+    int handles[7];
+    int i;
+    for (i = 0; i < 7; ++i)
+    {
+        status |= priority_queue_push(&q, &values[i], &handles[i]);
+    }
+    printf("Push 7 values:          (status %d)\n", status);
+    printf("Size:                        %5d\n", priority_queue_size(&q));
+    printf("Top:                         %5d\n", *(int*) priority_queue_top(&q));
+
+    int value = 1;
+    status = priority_queue_update(&q, handles[4], &value);
+    printf("Decrease 88 to %d:       (status %d)\n", value, status);
+    printf("Top:                         %5d\n", *(int*) priority_queue_top(&q));
+
+    status = priority_queue_erase(&q, handles[1], &value);
+    printf("Erase %d:                (status %d)\n", value, status);
+    printf("Erase %d again:          (status %d)\n", value, priority_queue_erase(&q, handles[1], NULL));
+
+    printf("\n");
+    while (!priority_queue_empty(&q))
+    {
+        priority_queue_pop(&q, &value);
+        printf("pop = %d\n", value);
+    }
+    printf("\n");
+    printf("Pop empty:              (status %d)\n", priority_queue_pop(&q, NULL));
+    printf("Free:                   (status %d)\n", priority_queue_free(&q));
+
+    vector v;
+    vector_init_packed(&v, sizeof(int), 0, 0);
+    for (i = 0; i < 1000; ++i)
+    {
+        value = (i * 7919) % 1000;
+        v.push_back(&v, &value);
+    }
+    status = priority_queue_init(&q, sizeof(int), PRIORITY_QUEUE_BINARY, compare_int);
+    printf("Init binary:            (status %d)\n", status);
+    status = priority_queue_heapify(&q, &v);
+    printf("Heapify 1000 values:    (status %d)\n", status);
+
+    int previous = -1;
+    int ordered = true;
+    while (priority_queue_pop(&q, &value) == SUCCESS)
+    {
+        ordered &= previous <= value;
+        previous = value;
+    }
+    printf("Popped in order:        (status %d)\n", !ordered);
+    printf("Free:                   (status %d)\n", priority_queue_free(&q));
+    v.free(&v);
+
+    return 0;
+}
@@ -0,0 +1,527 @@
+/**
+ * @file    ring_buffer.h - Bounded lock-free queues between threads
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#pragma once
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "../utils.h"
+
+/**
+ * Size of a cache line. Indices written by different threads are kept on
+ * different lines so that they do not invalidate each other
+ */
+#ifndef RING_CACHE_LINE
+#define RING_CACHE_LINE 64
+#endif
+
+/**
+ * Fixed-capacity queue with one producer thread and one consumer thread.
+ * Indices run freely and are masked into the storage, whose capacity is a
+ * power of two. Each side keeps a private copy of the other side's index and
+ * reloads it only when the ring looks full (or empty)
+ */
+typedef struct spsc_ring {
+
+    /**
+     * Next element to pop, written by the consumer
+     */
+    _Alignas(RING_CACHE_LINE) atomic_size_t head;
+
+    /**
+     * Last tail seen by the consumer
+     */
+    size_t cached_tail;
+
+    /**
+     * Next free slot, written by the producer
+     */
+    _Alignas(RING_CACHE_LINE) atomic_size_t tail;
+
+    /**
+     * Last head seen by the producer
+     */
+    size_t cached_head;
+
+    /**
+     * Storage of the elements
+     */
+    _Alignas(RING_CACHE_LINE) unsigned char* items;
+
+    /**
+     * Capacity - 1
+     */
+    size_t mask;
+
+    /**
+     * Size of an element in Bytes
+     */
+    int type_size;
+
+} spsc_ring;
+
+/**
+ * Fixed-capacity queue any number of threads can push to and pop from.
+ * Every slot carries a sequence number telling whether it is ready to be
+ * written or read in the current lap, so that threads only contend on the
+ * index they advance
+ */
+typedef struct mpmc_ring {
+
+    /**
+     * Next slot to write, advanced by producers
+     */
+    _Alignas(RING_CACHE_LINE) atomic_size_t tail;
+
+    /**
+     * Next slot to read, advanced by consumers
+     */
+    _Alignas(RING_CACHE_LINE) atomic_size_t head;
+
+    /**
+     * Slots, each a sequence number followed by the element
+     */
+    _Alignas(RING_CACHE_LINE) unsigned char* slots;
+
+    /**
+     * Distance between two consecutive slots in Bytes
+     */
+    size_t slot_size;
+
+    /**
+     * Capacity - 1
+     */
+    size_t mask;
+
+    /**
+     * Size of an element in Bytes
+     */
+    int type_size;
+
+} mpmc_ring;
+
+/**
+ * Returns the smallest power of two not below capacity, 0 on overflow
+ */
+size_t ring_capacity(size_t capacity)
+{
+    size_t rounded = 1;
+    while (rounded < capacity && rounded)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+/**
+ * Initializes an empty SPSC ring
+ *
+ * @param r pointer to the ring
+ * @param type_size size of an element in Bytes
+ * @param capacity minimum number of elements, rounded up to a power of two
+ * @return status
+ */
+int spsc_ring_init(spsc_ring* r, int type_size, int capacity)
+{
+    int status = FAILURE;
+    if (!r || type_size <= 0 || capacity <= 0)
+    {
+        return status;
+    }
+
+    size_t slots = ring_capacity((size_t) capacity);
+    r -> items = malloc(slots * type_size);
+    if (!r -> items)
+    {
+        return status;
+    }
+    atomic_init(&r -> head, 0);
+    atomic_init(&r -> tail, 0);
+    r -> cached_head = 0;
+    r -> cached_tail = 0;
+    r -> mask = slots - 1;
+    r -> type_size = type_size;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Returns the number of elements the ring can hold
+ */
+int spsc_ring_capacity(spsc_ring* r)
+{
+    return r ? (int) (r -> mask + 1) : VALUE_ERROR;
+}
+
+/**
+ * Returns the number of elements in the ring. Exact only when called by the
+ * producer or the consumer while the other side is idle
+ */
+int spsc_ring_size(spsc_ring* r)
+{
+    if (!r)
+    {
+        return VALUE_ERROR;
+    }
+    size_t tail = atomic_load_explicit(&r -> tail, memory_order_acquire);
+    size_t head = atomic_load_explicit(&r -> head, memory_order_acquire);
+    return (int) (tail - head);
+}
+
+/**
+ * Copies count elements between the ring storage, starting from index, and
+ * a contiguous buffer, wrapping around the end of the storage
+ */
+void ring_transfer(unsigned char* items, size_t mask, int type_size, size_t index,
+                   unsigned char* buffer, size_t count, int to_ring)
+{
+    size_t first = index & mask;
+    size_t until_end = min(count, mask + 1 - first);
+    unsigned char* slot = items + first * type_size;
+    if (to_ring)
+    {
+        copy(slot, buffer, until_end * type_size);
+        copy(items, buffer + until_end * type_size, (count - until_end) * type_size);
+    }
+    else
+    {
+        copy(buffer, slot, until_end * type_size);
+        copy(buffer + until_end * type_size, items, (count - until_end) * type_size);
+    }
+}
+
+/**
+ * Pushes up to count elements, stopping when the ring is full. Producer only
+ *
+ * @param r pointer to the ring
+ * @param values contiguous array of count elements
+ * @param count number of elements to push
+ * @return number of elements pushed
+ */
+int spsc_ring_push_batch(spsc_ring* r, const void* values, int count)
+{
+    if (!r || !values || count < 0)
+    {
+        return VALUE_ERROR;
+    }
+
+    size_t capacity = r -> mask + 1;
+    size_t tail = atomic_load_explicit(&r -> tail, memory_order_relaxed);
+    size_t free_slots = capacity - (tail - r -> cached_head);
+    if (free_slots < (size_t) count)
+    {
+        r -> cached_head = atomic_load_explicit(&r -> head, memory_order_acquire);
+        free_slots = capacity - (tail - r -> cached_head);
+    }
+
+    size_t pushed = min((size_t) count, free_slots);
+    if (pushed > 0)
+    {
+        ring_transfer(r -> items, r -> mask, r -> type_size, tail, (unsigned char*) values, pushed, true);
+        atomic_store_explicit(&r -> tail, tail + pushed, memory_order_release);
+    }
+    return (int) pushed;
+}
+
+/**
+ * Pops up to count elements, stopping when the ring is empty. Consumer only
+ *
+ * @param r pointer to the ring
+ * @param values contiguous array receiving up to count elements
+ * @param count maximum number of elements to pop
+ * @return number of elements popped
+ */
+int spsc_ring_pop_batch(spsc_ring* r, void* values, int count)
+{
+    if (!r || !values || count < 0)
+    {
+        return VALUE_ERROR;
+    }
+
+    size_t head = atomic_load_explicit(&r -> head, memory_order_relaxed);
+    size_t available = r -> cached_tail - head;
+    if (available < (size_t) count)
+    {
+        r -> cached_tail = atomic_load_explicit(&r -> tail, memory_order_acquire);
+        available = r -> cached_tail - head;
+    }
+
+    size_t popped = min((size_t) count, available);
+    if (popped > 0)
+    {
+        ring_transfer(r -> items, r -> mask, r -> type_size, head, values, popped, false);
+        atomic_store_explicit(&r -> head, head + popped, memory_order_release);
+    }
+    return (int) popped;
+}
+
+/**
+ * Pushes an element. Producer only
+ *
+ * @param r pointer to the ring
+ * @param value to push
+ * @return status, FAILURE when the ring is full
+ */
+int spsc_ring_push(spsc_ring* r, const void* value)
+{
+    return spsc_ring_push_batch(r, value, 1) == 1 ? SUCCESS : FAILURE;
+}
+
+/**
+ * Pops an element. Consumer only
+ *
+ * @param r pointer to the ring
+ * @param value receiving the element
+ * @return status, FAILURE when the ring is empty
+ */
+int spsc_ring_pop(spsc_ring* r, void* value)
+{
+    return spsc_ring_pop_batch(r, value, 1) == 1 ? SUCCESS : FAILURE;
+}
+
+/**
+ * Releases the storage of the ring. No thread may be using it
+ *
+ * @param r pointer to the ring
+ * @return status
+ */
+int spsc_ring_free(spsc_ring* r)
+{
+    int status = FAILURE;
+    if (r && r -> items)
+    {
+        free(r -> items);
+        r -> items = NULL;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Returns the sequence number of the slot holding index
+ */
+atomic_size_t* mpmc_sequence(mpmc_ring* r, size_t index)
+{
+    return (atomic_size_t*) (r -> slots + (index & r -> mask) * r -> slot_size);
+}
+
+/**
+ * Returns the element of the slot holding index
+ */
+unsigned char* mpmc_element(mpmc_ring* r, size_t index)
+{
+    return (unsigned char*) mpmc_sequence(r, index) + sizeof(atomic_size_t);
+}
+
+/**
+ * Initializes an empty MPMC ring
+ *
+ * @param r pointer to the ring
+ * @param type_size size of an element in Bytes
+ * @param capacity minimum number of elements, rounded up to a power of two
+ * @return status
+ */
+int mpmc_ring_init(mpmc_ring* r, int type_size, int capacity)
+{
+    int status = FAILURE;
+    if (!r || type_size <= 0 || capacity <= 0)
+    {
+        return status;
+    }
+
+    size_t slots = ring_capacity((size_t) capacity);
+    size_t align = _Alignof(atomic_size_t);
+    r -> slot_size = (sizeof(atomic_size_t) + type_size + align - 1) & ~(align - 1);
+    r -> slots = malloc(slots * r -> slot_size);
+    if (!r -> slots)
+    {
+        return status;
+    }
+    r -> mask = slots - 1;
+    r -> type_size = type_size;
+
+    // Slot i becomes writable when tail reaches i
+    size_t i;
+    for (i = 0; i < slots; ++i)
+    {
+        atomic_init(mpmc_sequence(r, i), i);
+    }
+    atomic_init(&r -> head, 0);
+    atomic_init(&r -> tail, 0);
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Returns the number of elements the ring can hold
+ */
+int mpmc_ring_capacity(mpmc_ring* r)
+{
+    return r ? (int) (r -> mask + 1) : VALUE_ERROR;
+}
+
+/**
+ * Returns the number of elements claimed by producers and not yet claimed by
+ * consumers. Only a snapshot while other threads are running
+ */
+int mpmc_ring_size(mpmc_ring* r)
+{
+    if (!r)
+    {
+        return VALUE_ERROR;
+    }
+    size_t head = atomic_load_explicit(&r -> head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&r -> tail, memory_order_acquire);
+    return tail > head ? (int) (tail - head) : 0;
+}
+
+/**
+ * Claims up to count consecutive slots whose sequence is index + lap, index
+ * being read from the given position and advanced past them
+ *
+ * @return number of slots claimed, the first one being *claimed
+ */
+size_t mpmc_claim(mpmc_ring* r, atomic_size_t* position, size_t lap, size_t count, size_t* claimed)
+{
+    size_t index = atomic_load_explicit(position, memory_order_relaxed);
+    while (true)
+    {
+        size_t ready = 0;
+        while (ready < count)
+        {
+            size_t sequence = atomic_load_explicit(mpmc_sequence(r, index + ready), memory_order_acquire);
+            if (sequence != index + ready + lap)
+            {
+                break;
+            }
+            ready++;
+        }
+
+        if (ready == 0)
+        {
+            size_t sequence = atomic_load_explicit(mpmc_sequence(r, index), memory_order_acquire);
+            if ((intptr_t) (sequence - (index + lap)) < 0)
+            {
+                // Slot still owned by the previous lap: full or empty
+                return 0;
+            }
+            // Another thread claimed it in the meantime
+            index = atomic_load_explicit(position, memory_order_relaxed);
+        }
+        else if (atomic_compare_exchange_weak_explicit(position, &index, index + ready,
+                                                       memory_order_relaxed, memory_order_relaxed))
+        {
+            *claimed = index;
+            return ready;
+        }
+    }
+}
+
+/**
+ * Pushes up to count elements with a single claim, stopping at the first slot
+ * that is not free yet
+ *
+ * @param r pointer to the ring
+ * @param values contiguous array of count elements
+ * @param count number of elements to push
+ * @return number of elements pushed
+ */
+int mpmc_ring_push_batch(mpmc_ring* r, const void* values, int count)
+{
+    if (!r || !values || count < 0)
+    {
+        return VALUE_ERROR;
+    }
+
+    size_t index = 0;
+    size_t pushed = count > 0 ? mpmc_claim(r, &r -> tail, 0, (size_t) count, &index) : 0;
+    size_t i;
+    for (i = 0; i < pushed; ++i)
+    {
+        copy(mpmc_element(r, index + i), (const unsigned char*) values + i * r -> type_size, r -> type_size);
+        atomic_store_explicit(mpmc_sequence(r, index + i), index + i + 1, memory_order_release);
+    }
+    return (int) pushed;
+}
+
+/**
+ * Pops up to count elements with a single claim, stopping at the first slot
+ * that is not written yet
+ *
+ * @param r pointer to the ring
+ * @param values contiguous array receiving up to count elements
+ * @param count maximum number of elements to pop
+ * @return number of elements popped
+ */
+int mpmc_ring_pop_batch(mpmc_ring* r, void* values, int count)
+{
+    if (!r || !values || count < 0)
+    {
+        return VALUE_ERROR;
+    }
+
+    size_t index = 0;
+    size_t popped = count > 0 ? mpmc_claim(r, &r -> head, 1, (size_t) count, &index) : 0;
+    size_t i;
+    for (i = 0; i < popped; ++i)
+    {
+        copy((unsigned char*) values + i * r -> type_size, mpmc_element(r, index + i), r -> type_size);
+        // Writable again once tail comes back to this slot on the next lap
+        atomic_store_explicit(mpmc_sequence(r, index + i), index + i + r -> mask + 1, memory_order_release);
+    }
+    return (int) popped;
+}
+
+/**
+ * Pushes an element
+ *
+ * @param r pointer to the ring
+ * @param value to push
+ * @return status, FAILURE when the ring is full
+ */
+int mpmc_ring_push(mpmc_ring* r, const void* value)
+{
+    return mpmc_ring_push_batch(r, value, 1) == 1 ? SUCCESS : FAILURE;
+}
+
+/**
+ * Pops an element
+ *
+ * @param r pointer to the ring
+ * @param value receiving the element
+ * @return status, FAILURE when the ring is empty
+ */
+int mpmc_ring_pop(mpmc_ring* r, void* value)
+{
+    return mpmc_ring_pop_batch(r, value, 1) == 1 ? SUCCESS : FAILURE;
+}
+
+/**
+ * Releases the storage of the ring. No thread may be using it
+ *
+ * @param r pointer to the ring
+ * @return status
+ */
+int mpmc_ring_free(mpmc_ring* r)
+{
+    int status = FAILURE;
+    if (r && r -> slots)
+    {
+        free(r -> slots);
+        r -> slots = NULL;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+#endif
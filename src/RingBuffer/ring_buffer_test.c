@@ -0,0 +1,155 @@
+/**
+ * @file    ring_buffer_test.c - Main program for testing the ring buffers
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "./ring_buffer.h"
+
+#define ITEMS 1000000LL
+#define BATCH 64
+#define PRODUCERS 2
+#define CONSUMERS 2
+
+spsc_ring spsc;
+mpmc_ring mpmc;
+atomic_llong consumed_sum;
+atomic_llong consumed_count;
+
+void* spsc_producer(void* arg)
+{
+    (void) arg;
+    long long batch[BATCH];
+    long long next = 0;
+    while (next < ITEMS)
+    {
+        int count = 0;
+        while (count < BATCH && next + count < ITEMS)
+        {
+            batch[count] = next + count;
+            count++;
+        }
+        int pushed = 0;
+        while (pushed < count)
+        {
+            int done = spsc_ring_push_batch(&spsc, batch + pushed, count - pushed);
+            if (done == 0)
+            {
+                sched_yield();
+            }
+            pushed += done;
+        }
+        next += count;
+    }
+    return NULL;
+}
+
+void* mpmc_producer(void* arg)
+{
+    long long first = *(long long*) arg;
+    long long i;
+    for (i = first; i < ITEMS; i += PRODUCERS)
+    {
+        while (mpmc_ring_push(&mpmc, &i) != SUCCESS)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void* mpmc_consumer(void* arg)
+{
+    (void) arg;
+    long long batch[BATCH];
+    while (atomic_load(&consumed_count) < ITEMS)
+    {
+        int popped = mpmc_ring_pop_batch(&mpmc, batch, BATCH);
+        if (popped == 0)
+        {
+            sched_yield();
+        }
+        int i;
+        for (i = 0; i < popped; ++i)
+        {
+            atomic_fetch_add(&consumed_sum, batch[i]);
+        }
+        atomic_fetch_add(&consumed_count, popped);
+    }
+    return NULL;
+}
+
+int main()
+{
+    int status = spsc_ring_init(&spsc, sizeof(long long), 1000);
+    printf("SPSC init:              (status %d)\n", status);
+    printf("SPSC capacity:               %5d\n", spsc_ring_capacity(&spsc));
+
+    long long value = 42;
+    printf("SPSC push %lld:          (status %d)\n", value, spsc_ring_push(&spsc, &value));
+    printf("SPSC size:                   %5d\n", spsc_ring_size(&spsc));
+    value = 0;
+    status = spsc_ring_pop(&spsc, &value);
+    printf("SPSC pop %lld:           (status %d)\n", value, status);
+    printf("SPSC pop empty:         (status %d)\n", spsc_ring_pop(&spsc, &value));
+
+    pthread_t producer;
+    pthread_create(&producer, NULL, spsc_producer, NULL);
+    long long batch[BATCH];
+    long long expected = 0;
+    int in_order = true;
+    while (expected < ITEMS)
+    {
+        int popped = spsc_ring_pop_batch(&spsc, batch, BATCH);
+        if (popped == 0)
+        {
+            sched_yield();
+        }
+        int i;
+        for (i = 0; i < popped; ++i)
+        {
+            in_order &= batch[i] == expected++;
+        }
+    }
+    pthread_join(producer, NULL);
+    printf("SPSC %lld in order:   (status %d)\n", ITEMS, !in_order);
+    printf("SPSC free:              (status %d)\n", spsc_ring_free(&spsc));
+
+    status = mpmc_ring_init(&mpmc, sizeof(long long), 256);
+    printf("MPMC init:              (status %d)\n", status);
+    printf("MPMC capacity:               %5d\n", mpmc_ring_capacity(&mpmc));
+
+    pthread_t producers[PRODUCERS];
+    pthread_t consumers[CONSUMERS];
+    long long firsts[PRODUCERS];
+    int i;
+    for (i = 0; i < CONSUMERS; ++i)
+    {
+        pthread_create(&consumers[i], NULL, mpmc_consumer, NULL);
+    }
+    for (i = 0; i < PRODUCERS; ++i)
+    {
+        firsts[i] = i;
+        pthread_create(&producers[i], NULL, mpmc_producer, &firsts[i]);
+    }
+    for (i = 0; i < PRODUCERS; ++i)
+    {
+        pthread_join(producers[i], NULL);
+    }
+    for (i = 0; i < CONSUMERS; ++i)
+    {
+        pthread_join(consumers[i], NULL);
+    }
+    long long sum = atomic_load(&consumed_sum);
+    printf("MPMC sum %lld: (status %d)\n", sum, sum != ITEMS * (ITEMS - 1) / 2);
+    printf("MPMC size:                   %5d\n", mpmc_ring_size(&mpmc));
+    printf("MPMC free:              (status %d)\n", mpmc_ring_free(&mpmc));
+
+    return 0;
+}
@@ -15,11 +15,33 @@
 #include <stdlib.h>
 #include <limits.h>
 #include "../utils.h"
+#include "../Allocator/allocator.h"
+#include "../sort.h"
+#include "./vector_stats.h"
 
 #define VECTOR_INIT_CAPACITY 1
 #define VECTOR_INIT_SIZE 0
 #define VECTOR_DEFAULT_ITEMSIZE 8
 #define VECTOR_DEFAULT_TYPESIZE 8
+#define VECTOR_DEFAULT_GROWTH_FACTOR 2.0
+#define VECTOR_DEFAULT_MIN_CHUNK 4
+
+/**
+ * Bytes stored inside the vector itself before spilling to the allocator.
+ * Can be overridden before including this header
+ */
+#ifndef VECTOR_INLINE_BYTES
+#define VECTOR_INLINE_BYTES 128
+#endif
+
+/**
+ * Tells whether an element matches
+ *
+ * @param element pointer to the element
+ * @param context passed through by the caller
+ * @return true if the element matches
+ */
+typedef int (*predicate)(const void* element, void* context);
 
 /**
 * Members of the vector
@@ -37,7 +59,7 @@ typedef struct members {
     int capacity;
 
     /**
-     * Size of an element in Bytes
+     * Size of an element in Bytes (distance between two consecutive elements)
      */
     int item_size;
 
@@ -47,9 +69,49 @@ typedef struct members {
     int type_size;
 
     /**
-     * Array of pointers to elements
+     * Contiguous storage of the elements, laid out at item_size stride
+     */
+    void* items;
+
+    /**
+     * Factor the capacity is multiplied by when the vector has to grow
+     */
+    double growth_factor;
+
+    /**
+     * Minimum number of elements added to the capacity on each growth
+     */
+    int min_chunk;
+
+    /**
+     * Number of times the storage has been reallocated
+     */
+    int reallocations;
+
+    /**
+     * Allocator owning the storage of the elements
+     */
+    allocator allocator;
+
+    /**
+     * Bytes of the inline buffer the vector may use, zero when the storage
+     * always has to come from the allocator
+     */
+    int inline_bytes;
+
+    /**
+     * Storage used while the elements fit in it, so that short vectors
+     * never touch the allocator. A vector must not be copied by value
+     * while items points here
+     */
+    _Alignas(max_align_t) unsigned char inline_buffer[VECTOR_INLINE_BYTES];
+
+#ifdef VECTOR_STATS
+    /**
+     * Instrumentation counters, only with VECTOR_STATS defined
      */
-    void** items;
+    vector_stats stats;
+#endif
 
 } members;
 
@@ -64,6 +126,16 @@ struct SVector {
      */
     members members;
 
+    /**
+     * Adds count elements at the end of the vector
+     *
+     * @param v pointer to the vector
+     * @param src array of count elements of type_size bytes
+     * @param count number of elements to add
+     * @return status
+     */
+    int (*append)(vector*, const void*, int);
+
     /**
      * Assigns a value to a specified index
      *
@@ -74,6 +146,16 @@ struct SVector {
      */
     int (*assign)(vector*, const void*, int);
 
+    /**
+     * Replaces the content of the vector with count elements
+     *
+     * @param v pointer to the vector
+     * @param src array of count elements of type_size bytes
+     * @param count number of elements
+     * @return status
+     */
+    int (*assign_range)(vector*, const void*, int);
+
     /**
      * Returns the i-th element
      *
@@ -99,6 +181,16 @@ struct SVector {
      */
     void* (*begin)(vector*);
 
+    /**
+     * Checks whether a value is in the vector, sorted by cmp
+     *
+     * @param v pointer to the vector
+     * @param value to look for
+     * @param cmp comparator the vector is sorted by
+     * @return if the value is found
+     */
+    int (*binary_search)(vector*, const void*, comparator);
+
     /**
      * Returns the current capacity
      *
@@ -149,6 +241,16 @@ struct SVector {
      */
     int (*erase_element)(vector*, const void*);
 
+    /**
+     * Removes every element matching pred, keeping the order of the others
+     *
+     * @param v pointer to the vector
+     * @param pred tells which elements to remove
+     * @param context passed to pred
+     * @return number of elements removed
+     */
+    int (*erase_if)(vector*, predicate, void*);
+
     /**
      * Deletes the element at the i-th position
      *
@@ -158,6 +260,16 @@ struct SVector {
      */
     int (*erase_index)(vector*, int);
 
+    /**
+     * Deletes the elements in the interval [first, last)
+     *
+     * @param v pointer to the vector
+     * @param first index of the first element to remove
+     * @param last index after the last element to remove
+     * @return status
+     */
+    int (*erase_range)(vector*, int, int);
+
     /**
      * Fills up the vector with the given value
      *
@@ -208,6 +320,14 @@ struct SVector {
      */
     int (*get_type_size)(vector*);
 
+    /**
+     * Returns the number of times the storage has been reallocated
+     *
+     * @param v pointer to the vector
+     * @return number of reallocations
+     */
+    int (*get_reallocations)(vector*);
+
     /**
      * Inserts an element at the i-th index
      *
@@ -218,6 +338,50 @@ struct SVector {
      */
     int (*insert)(vector*, const void*, int);
 
+    /**
+     * Inserts count elements starting at the i-th index
+     *
+     * @param v pointer to the vector
+     * @param pos index, between 0 and size
+     * @param src array of count elements of type_size bytes
+     * @param count number of elements to insert
+     * @return status
+     */
+    int (*insert_range)(vector*, int, const void*, int);
+
+    /**
+     * Returns the index of the first element not coming before value, in
+     * the vector sorted by cmp
+     *
+     * @param v pointer to the vector
+     * @param value to look for
+     * @param cmp comparator the vector is sorted by
+     * @return index between 0 and size
+     */
+    int (*lower_bound)(vector*, const void*, comparator);
+
+    /**
+     * Places at the nth index the element which would be there if the vector
+     * was sorted, with smaller elements before it and bigger ones after it
+     *
+     * @param v pointer to the vector
+     * @param nth index of the element to place
+     * @param cmp comparator
+     * @return status
+     */
+    int (*nth_element)(vector*, int, comparator);
+
+    /**
+     * Sorts the smallest middle elements at the beginning of the vector,
+     * leaving the other ones in unspecified order
+     *
+     * @param v pointer to the vector
+     * @param middle number of elements to sort
+     * @param cmp comparator
+     * @return status
+     */
+    int (*partial_sort)(vector*, int, comparator);
+
     /**
      * Removes the last element
      *
@@ -245,7 +409,8 @@ struct SVector {
 
     /**
      * Reversed end iterator (points a chunk of memory before
-     * the first element
+     * the first element. Deprecated: C doesn't allow that address to be
+     * formed, vector_span_reverse walks the vector backwards instead
      *
      * @param v pointer to the vector
      * @return address of the chunk before the first element
@@ -253,18 +418,40 @@ struct SVector {
     void* (*rend)(vector*);
 
     /**
-     * It removes elements when compare function returns true within the
-     * interval [start, end).
+     * Removes the elements matching pred within the interval [start, end),
+     * keeping the order of the others
+     *
+     * @param v pointer to the vector
+     * @param start index which to start from
+     * @param end index which to finish to
+     * @param pred tells which elements to remove
+     * @param context passed to pred
+     * @return number of elements removed
+     */
+    int (*remove_if)(vector*, int, int, predicate, void*);
+
+    /**
+     * Removes the elements matching pred within the interval [start, end),
+     * filling each hole with the last element of the interval. The order of
+     * the remaining elements is not kept
      *
      * @param v pointer to the vector
      * @param start index which to start from
      * @param end index which to finish to
-     * @param value to compare elements with
-     * @param value_size size of the type of data stored in bytes
-     * @param compare function used to determine whether to remove an element
+     * @param pred tells which elements to remove
+     * @param context passed to pred
      * @return number of elements removed
      */
-    int (*remove_if)(vector*, int, int, const void*, int, int (*)(const void*, const void*, int));
+    int (*remove_if_unordered)(vector*, int, int, predicate, void*);
+
+    /**
+     * Makes room for at least the given number of elements
+     *
+     * @param v pointer to the vector
+     * @param new_capacity minimum capacity to guarantee
+     * @return status
+     */
+    int (*reserve)(vector*, int);
 
     /**
      * Properly upgrades size and capacity
@@ -275,6 +462,18 @@ struct SVector {
      */
     int (*resize)(vector*, int);
 
+    /**
+     * Sets the growth policy used when the vector runs out of capacity: the
+     * new capacity is the biggest between the requested size, the current
+     * capacity times growth_factor and the current capacity plus min_chunk
+     *
+     * @param v pointer to the vector
+     * @param growth_factor factor the capacity is multiplied by (> 1)
+     * @param min_chunk minimum number of elements added on each growth (> 0)
+     * @return status
+     */
+    int (*set_growth)(vector*, double, int);
+
     /**
      * Shrinks capacity to the size
      *
@@ -283,6 +482,24 @@ struct SVector {
      */
     int (*shrink)(vector*);
 
+    /**
+     * Sorts the elements
+     *
+     * @param v pointer to the vector
+     * @param cmp comparator
+     * @return status
+     */
+    int (*sort)(vector*, comparator);
+
+    /**
+     * Sorts the elements, keeping equivalent ones in their original order
+     *
+     * @param v pointer to the vector
+     * @param cmp comparator
+     * @return status
+     */
+    int (*stable_sort)(vector*, comparator);
+
     /**
      * Returns the current size
      *
@@ -290,11 +507,46 @@ struct SVector {
      * @return current size
      */
     int (*size)(vector*);
-    
+
+    /**
+     * Returns the index of the first element coming after value, in the
+     * vector sorted by cmp
+     *
+     * @param v pointer to the vector
+     * @param value to look for
+     * @param cmp comparator the vector is sorted by
+     * @return index between 0 and size
+     */
+    int (*upper_bound)(vector*, const void*, comparator);
+
 };
 
 /**
- * Updates vector's capacity
+ * Returns the address of the i-th element, without any bounds check
+ *
+ * @param  v pointer to the vector
+ * @param  index of the element
+ * @return address of the element
+ */
+void* item_address(vector* v, int index)
+{
+    return (unsigned char*) v -> members.items + (long long) index * v -> members.item_size;
+}
+
+/**
+ * Checks whether the elements are stored in the inline buffer
+ *
+ * @param  v pointer to the vector
+ * @return if the storage is inline
+ */
+int is_inline(vector* v)
+{
+    return v -> members.items == (void*) v -> members.inline_buffer;
+}
+
+/**
+ * Updates vector's capacity. Capacities fitting in the inline bytes use
+ * the inline buffer, bigger ones are requested to the allocator
  *
  * @param  v pointer to the vector
  * @param  new_capacity of the vector
@@ -302,15 +554,118 @@ struct SVector {
  */
 int update_capacity(vector* v, int new_capacity)
 {
+    VECTOR_STATS_START(start);
     int status = FAILURE;
-    int bytes = new_capacity * (int) sizeof(void*);
-    void** temp = malloc(bytes);
+    size_t item_size = v -> members.item_size;
+    size_t bytes = new_capacity * item_size;
+    size_t kept = min(v -> members.size, new_capacity) * item_size;
+    allocator* a = &v -> members.allocator;
+    void* temp = NULL;
+    if (bytes <= (size_t) v -> members.inline_bytes)
+    {
+        temp = v -> members.inline_buffer;
+        if (v -> members.items && !is_inline(v))
+        {
+            if (kept > 0)
+            {
+                copy(temp, v -> members.items, kept);
+                VECTOR_STATS_ADD(v, bytes_copied, kept);
+            }
+            a -> free(a -> context, v -> members.items, v -> members.capacity * item_size);
+        }
+    }
+    else if (!v -> members.items || is_inline(v))
+    {
+        temp = a -> alloc(a -> context, bytes);
+        if (temp && v -> members.items && kept > 0)
+        {
+            copy(temp, v -> members.items, kept);
+            VECTOR_STATS_ADD(v, bytes_copied, kept);
+        }
+        v -> members.reallocations += (temp != NULL);
+        VECTOR_STATS_ADD(v, reallocations, temp != NULL);
+    }
+    else
+    {
+        temp = a -> realloc(a -> context, v -> members.items, v -> members.capacity * item_size, bytes);
+        v -> members.reallocations += (temp != NULL);
+        VECTOR_STATS_ADD(v, reallocations, temp != NULL);
+        // A block extended in place copies nothing
+        VECTOR_STATS_ADD(v, bytes_copied, temp != NULL && temp != v -> members.items ? kept : 0);
+    }
+
     if (temp)
     {
-        v -> members.capacity = new_capacity;
-        status = copy(temp, v -> begin(v), bytes);
-        free(v -> begin(v));
+        status = SUCCESS;
         v -> members.items = temp;
+        v -> members.capacity = new_capacity;
+        VECTOR_STATS_PEAK(v);
+    }
+    VECTOR_STATS_STOP(v, VECTOR_OP_GROW, start);
+    return status;
+}
+
+/**
+ * Computes the capacity to grow to in order to hold the given number of
+ * elements, according to the growth policy of the vector
+ *
+ * @param  v pointer to the vector
+ * @param  needed number of elements to hold
+ * @return new capacity
+ */
+int grown_capacity(vector* v, int needed)
+{
+    long long capacity = v -> members.capacity;
+    long long scaled = (long long) min(capacity * v -> members.growth_factor, (double) INT_MAX);
+    long long new_capacity = max(max((long long) needed, scaled), capacity + v -> members.min_chunk);
+    return (int) min(new_capacity, (long long) INT_MAX);
+}
+
+/**
+ * Copies count elements from a packed array into the vector, starting at
+ * the given index. Doesn't check bounds
+ *
+ * @param  v pointer to the vector
+ * @param  index of the first element to write
+ * @param  src array of count elements of type_size bytes
+ * @param  count number of elements to copy
+ * @return status
+ */
+int copy_items(vector* v, int index, const void* src, int count)
+{
+    int status = SUCCESS;
+    int type_size = v -> members.type_size;
+    int item_size = v -> members.item_size;
+    if (item_size == type_size)
+    {
+        status = copy(item_address(v, index), src, (size_t) count * item_size);
+    }
+    else
+    {
+        const unsigned char* bytes = (const unsigned char*) src;
+        int i;
+        for (i = 0; i < count; ++i)
+        {
+            status |= copy(item_address(v, index + i), bytes + (size_t) i * type_size, type_size);
+        }
+    }
+    return status;
+}
+
+/**
+ * Adds count elements at the end of the vector
+ *
+ * @param v pointer to the vector
+ * @param src array of count elements of type_size bytes
+ * @param count number of elements to add
+ * @return status
+ */
+int vappend(vector* v, const void* src, int count)
+{
+    int status = FAILURE;
+    if (v)
+    {
+        status = v -> insert_range(v, v -> size(v), src, count);
     }
     return status;
 }
@@ -332,7 +687,7 @@ int vassign(vector *v, const void *value, int index) {
             return status;
         }
 
-        void* destination = v -> members.items + index;
+        void* destination = item_address(v, index);
         int type_size = v -> get_type_size(v);
         if (destination && type_size != VALUE_ERROR)
         {
@@ -343,6 +698,33 @@ int vassign(vector *v, const void *value, int index) {
     return status;
 }
 
+/**
+ * Replaces the content of the vector with count elements
+ *
+ * @param v pointer to the vector
+ * @param src array of count elements of type_size bytes
+ * @param count number of elements
+ * @return status
+ */
+int vassign_range(vector* v, const void* src, int count)
+{
+    int status = FAILURE;
+    if (v)
+    {
+        if (!src || count < 0)
+        {
+            return status;
+        }
+
+        status = v -> resize(v, count);
+        if (status == SUCCESS && count > 0)
+        {
+            status = copy_items(v, 0, src, count);
+        }
+    }
+    return status;
+}
+
 /**
  * Returns the i-th element
  *
@@ -359,7 +741,7 @@ void* vat(vector* v, int index)
         {
             return value;
         }
-        value = v -> members.items + index;
+        value = item_address(v, index);
     }
     return value;
 }
@@ -395,11 +777,30 @@ void* vbegin(vector* v)
     void* value = NULL;
     if (v)
     {
-        value = &v -> members.items[0];
+        value = v -> members.items;
     }
     return value;
 }
 
+/**
+ * Checks whether a value is in the vector, sorted by cmp
+ *
+ * @param v pointer to the vector
+ * @param value to look for
+ * @param cmp comparator the vector is sorted by
+ * @return if the value is found
+ */
+int vbinary_search(vector* v, const void* value, comparator cmp)
+{
+    int found = false;
+    if (v)
+    {
+        int index = v -> lower_bound(v, value, cmp);
+        found = (index != VALUE_ERROR && index < v -> size(v) && cmp(item_address(v, index), value) == 0);
+    }
+    return found;
+}
+
 /**
  * Returns the current capacity
  *
@@ -461,7 +862,7 @@ int vcount(vector* v, const void* value)
         int i;
         for (i = 0; i < size; ++i)
         {
-            element = v -> members.items + i;
+            element = item_address(v, i);
             if (compare(element, value, type_size) == SUCCESS)
             {
                 count++;
@@ -499,7 +900,7 @@ void* vend(vector* v)
     void* value = NULL;
     if (v)
     {
-        value = &v -> members.items[v -> size(v)];
+        value = item_address(v, v -> size(v));
     }
     return value;
 }
@@ -527,28 +928,24 @@ int verase_element(vector* v, const void* element)
             return status;
         }
 
-        int type_size = v -> get_type_size(v);
-        if (type_size == VALUE_ERROR)
-        {
-            return status;
-        }
-
-        status = SUCCESS;
-        void* source = NULL;
-        void* destination = NULL;
-        int size = v -> size(v);
-        int i;
-        for (i = index + 1; i < size; ++i)
-        {
-            source = v -> members.items + i;
-            destination = v -> members.items + (i - 1);
-            status |= copy(destination, source, type_size);
-        }
-        status |= v -> resize(v, size - 1);
+        status = v -> erase_range(v, index, index + 1);
     }
     return status;
 }
 
+/**
+ * Removes every element matching pred, keeping the order of the others
+ *
+ * @param v pointer to the vector
+ * @param pred tells which elements to remove
+ * @param context passed to pred
+ * @return number of elements removed
+ */
+int verase_if(vector* v, predicate pred, void* context)
+{
+    return v ? v -> remove_if(v, 0, v -> size(v), pred, context) : VALUE_ERROR;
+}
+
 /**
  * Deletes the element at the i-th position
  *
@@ -558,32 +955,50 @@ int verase_element(vector* v, const void* element)
 */
 int verase_index(vector* v, int index)
 {
+    int status = FAILURE;
+    if (v)
+    {
+        status = v -> erase_range(v, index, index + 1);
+    }
+    return status;
+}
+
+/**
+ * Deletes the elements in the interval [first, last) shifting the following
+ * ones back with a single move. An empty interval leaves the vector as is
+ *
+ * @param v pointer to the vector
+ * @param first index of the first element to remove
+ * @param last index after the last element to remove
+ * @return status
+ */
+int verase_range(vector* v, int first, int last)
+{
+    VECTOR_STATS_START(start);
     int status = FAILURE;
     if (v)
     {
         int size = v -> size(v);
-        if (!v -> members.items || index < 0 || index >= size)
+        if (!v -> members.items || first < 0 || last > size || first > last)
         {
             return status;
         }
 
-        int type_size = v -> get_type_size(v);
-        if (type_size == VALUE_ERROR)
+        status = SUCCESS;
+        if (first == last)
         {
             return status;
         }
 
-        status = SUCCESS;
-        void* destination = NULL;
-        void* source = NULL;
-        int i;
-        for (i = index + 1; i < size; ++i)
+        if (last < size)
         {
-            source = v -> members.items + i;
-            destination = v -> members.items + i - 1;
-            status |= copy(destination, source, type_size);
+            size_t bytes = (size_t) (size - last) * v -> get_item_size(v);
+            status = move(item_address(v, first), item_address(v, last), bytes);
+            VECTOR_STATS_ADD(v, elements_shifted, size - last);
+            VECTOR_STATS_ADD(v, bytes_copied, bytes);
         }
-        status |= v -> resize(v, size - 1);
+        status |= v -> resize(v, size - (last - first));
+        VECTOR_STATS_STOP(v, VECTOR_OP_ERASE, start);
     }
     return status;
 }
@@ -612,7 +1027,7 @@ int vfill(vector* v, const void* value)
         int i;
         for (i = 0; i < size; ++i)
         {
-            destination = v -> members.items + i;
+            destination = item_address(v, i);
             status |= copy(destination, value, type_size);
         }
     }
@@ -628,6 +1043,7 @@ int vfill(vector* v, const void* value)
  */
 int vfind(vector* v, const void* value)
 {
+    VECTOR_STATS_START(start);
     int index = VALUE_ERROR;
     if (v)
     {
@@ -648,7 +1064,7 @@ int vfind(vector* v, const void* value)
         int i = 0;
         while (i < size && !found)
         {
-            item = v -> members.items + i;
+            item = item_address(v, i);
             found = (compare(item, value, type_size) == 0);
             i++;
         }
@@ -657,6 +1073,7 @@ int vfind(vector* v, const void* value)
         {
             index = i - 1;
         }
+        VECTOR_STATS_STOP(v, VECTOR_OP_FIND, start);
     }
     return index;
 }
@@ -672,9 +1089,15 @@ int vfree(vector* v)
     int status = FAILURE;
     if (v)
     {
-        free(v -> begin(v));
+        if (!is_inline(v))
+        {
+            allocator* a = &v -> members.allocator;
+            a -> free(a -> context, v -> members.items, (size_t) v -> capacity(v) * v -> get_item_size(v));
+        }
+        v -> members.items = NULL;
         v -> members.size = VECTOR_INIT_SIZE;
         status = update_capacity(v, VECTOR_INIT_CAPACITY);
+        v -> members.reallocations = 0;
     }
     return status;
 }
@@ -727,6 +1150,22 @@ int vget_type_size(vector* v)
     return type_size;
 }
 
+/**
+ * Returns the number of times the storage has been reallocated
+ *
+ * @param v pointer to the vector
+ * @return number of reallocations
+ */
+int vget_reallocations(vector* v)
+{
+    int reallocations = VALUE_ERROR;
+    if (v)
+    {
+        reallocations = v -> members.reallocations;
+    }
+    return reallocations;
+}
+
 /**
  * Inserts an element at the i-th index
  *
@@ -737,34 +1176,116 @@ int vget_type_size(vector* v)
  */
 int vinsert(vector* v, const void* item, int pos)
 {
+    int status = FAILURE;
+    if (v)
+    {
+        if (pos >= v -> size(v))
+        {
+            return status;
+        }
+
+        status = v -> insert_range(v, pos, item, 1);
+    }
+    return status;
+}
+
+/**
+ * Inserts count elements starting at the i-th index, shifting the following
+ * ones forward with a single move after at most one reallocation
+ *
+ * @param v pointer to the vector
+ * @param pos index, between 0 and size
+ * @param src array of count elements of type_size bytes
+ * @param count number of elements to insert
+ * @return status
+ */
+int vinsert_range(vector* v, int pos, const void* src, int count)
+{
+    VECTOR_STATS_START(start);
     int status = FAILURE;
     if (v)
     {
         int size = v -> size(v);
-        if (!item || pos < 0 || pos >= size)
+        if (!src || count < 0 || pos < 0 || pos > size || count > INT_MAX - size)
         {
             return status;
         }
 
-        int type_size = v -> get_type_size(v);
-        if (type_size == VALUE_ERROR)
+        status = v -> resize(v, size + count);
+        if (status != SUCCESS || count == 0)
         {
             return status;
         }
 
-        status = SUCCESS;
-        v -> resize(v, size + 1);
-        void* source = NULL;
-        void* destination = NULL;
-        int i;
-        for (i = size - 1; i >= pos; --i)
+        if (pos < size)
         {
-            source = v -> members.items + i;
-            destination = v -> members.items + (i + 1);
-            status |= copy(destination, source, type_size);
+            size_t bytes = (size_t) (size - pos) * v -> get_item_size(v);
+            status |= move(item_address(v, pos + count), item_address(v, pos), bytes);
+            VECTOR_STATS_ADD(v, elements_shifted, size - pos);
+            VECTOR_STATS_ADD(v, bytes_copied, bytes);
         }
-        destination = v -> members.items + pos;
-        status |= copy(destination, item, type_size);
+        status |= copy_items(v, pos, src, count);
+        VECTOR_STATS_ADD(v, bytes_copied, (long long) count * v -> get_type_size(v));
+        VECTOR_STATS_STOP(v, VECTOR_OP_INSERT, start);
+    }
+    return status;
+}
+
+/**
+ * Returns the index of the first element not coming before value, in the
+ * vector sorted by cmp
+ *
+ * @param v pointer to the vector
+ * @param value to look for
+ * @param cmp comparator the vector is sorted by
+ * @return index between 0 and size
+ */
+int vlower_bound(vector* v, const void* value, comparator cmp)
+{
+    int index = VALUE_ERROR;
+    if (v && value && cmp)
+    {
+        index = (int) lower_bound(v -> begin(v), v -> size(v), v -> get_item_size(v), value, cmp);
+    }
+    return index;
+}
+
+/**
+ * Places at the nth index the element which would be there if the vector
+ * was sorted, with smaller elements before it and bigger ones after it
+ *
+ * @param v pointer to the vector
+ * @param nth index of the element to place
+ * @param cmp comparator
+ * @return status
+ */
+int vnth_element(vector* v, int nth, comparator cmp)
+{
+    int status = FAILURE;
+    if (v && cmp && nth >= 0 && nth < v -> size(v))
+    {
+        nth_element(v -> begin(v), v -> size(v), nth, v -> get_item_size(v), cmp);
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Sorts the smallest middle elements at the beginning of the vector,
+ * leaving the other ones in unspecified order
+ *
+ * @param v pointer to the vector
+ * @param middle number of elements to sort
+ * @param cmp comparator
+ * @return status
+ */
+int vpartial_sort(vector* v, int middle, comparator cmp)
+{
+    int status = FAILURE;
+    if (v && cmp && middle >= 0 && middle <= v -> size(v))
+    {
+        partial_sort(v -> begin(v), v -> size(v), middle, v -> get_item_size(v), cmp);
+        status = SUCCESS;
     }
     return status;
 }
@@ -786,7 +1307,7 @@ void* vpop_back(vector* v)
         }
 
         int size = v -> size(v) - 1;
-        item = v -> members.items + size;
+        item = item_address(v, size);
         v -> resize(v, size);
     }
     return item;
@@ -801,6 +1322,7 @@ void* vpop_back(vector* v)
  */
 int vpush_back(vector* v, const void* value)
 {
+    VECTOR_STATS_START(start);
     int status = FAILURE;
     if (v)
     {
@@ -816,11 +1338,13 @@ int vpush_back(vector* v, const void* value)
             return status;
         }
 
-        void* position = v -> members.items + size;
+        void* position = item_address(v, size);
         if (position)
         {
             status = copy(position, value, v -> get_type_size(v));
         }
+        VECTOR_STATS_ADD(v, bytes_copied, v -> get_type_size(v));
+        VECTOR_STATS_STOP(v, VECTOR_OP_PUSH_BACK, start);
     }
     return status;
 }
@@ -836,70 +1360,145 @@ void* vrbegin(vector* v)
     void* value = NULL;
     if (v)
     {
-        value = v -> end(v) - sizeof(void*);
+        value = v -> end(v) - v -> get_item_size(v);
     }
     return value;
 }
 
 /**
- * It removes elements when compare function returns true within the
- * interval [start, end).
+ * Removes the elements matching pred within the interval [start, end),
+ * keeping the order of the others. Runs of kept elements are moved as a
+ * block in a single pass, without any auxiliary memory
  *
  * @param v pointer to the vector
  * @param start index which to start from
  * @param end index which to finish to
- * @param value to compare elements with
- * @param value_size size of the type of data stored in bytes
- * @param compare function used to determine whether to remove an element
+ * @param pred tells which elements to remove
+ * @param context passed to pred
  * @return number of elements removed
  */
-int vremove_if(vector* v, int start, int end, const void* value, int value_size, int (*custom_compare)(const void*, const void*, int))
+int vremove_if(vector* v, int start, int end, predicate pred, void* context)
 {
     int removes = VALUE_ERROR;
-    if (v && value_size > 0)
+    if (v && pred)
     {
-        if (start < 0 || end > v -> size(v) || start >= end)
+        int size = v -> size(v);
+        if (!v -> members.items || start < 0 || end > size || start > end)
         {
             return removes;
         }
 
-        int size = end - start;
-        int check[size];
-        int val = 0;
-        set(check, check + size, &val, sizeof(val));
-        long long first_one = -1;
-        long long starting_zero = -1;
-        int count_zero = 0;
-        long long i = start;
-        while (i < end)
+        size_t item_size = v -> get_item_size(v);
+        int write = start;
+        int run = start;
+        int i;
+        for (i = start; i < end; ++i)
         {
-            check[i] = (custom_compare(v -> members.items + i, value, value_size) == true);
-            count_zero += !check[i];
-            if (check[i] && first_one == -1) first_one = i;
-            else if (!check[i] && i > first_one && first_one != -1 && starting_zero == -1) starting_zero = i;
-            i++;
+            if (pred(item_address(v, i), context))
+            {
+                if (write < run)
+                {
+                    move(item_address(v, write), item_address(v, run), (size_t) (i - run) * item_size);
+                }
+                write += i - run;
+                run = i + 1;
+            }
         }
 
-        long long j;
-        for (j = starting_zero; j < end; ++j)
+        // The last run of kept elements and everything after end
+        if (write < run && run < size)
         {
-            if (!check[j])
+            move(item_address(v, write), item_address(v, run), (size_t) (size - run) * item_size);
+        }
+        removes = run - write;
+        v -> resize(v, size - removes);
+    }
+    return removes;
+}
+
+/**
+ * Removes the elements matching pred within the interval [start, end),
+ * filling each hole with the last element of the interval. The order of
+ * the remaining elements is not kept
+ *
+ * @param v pointer to the vector
+ * @param start index which to start from
+ * @param end index which to finish to
+ * @param pred tells which elements to remove
+ * @param context passed to pred
+ * @return number of elements removed
+ */
+int vremove_if_unordered(vector* v, int start, int end, predicate pred, void* context)
+{
+    int removes = VALUE_ERROR;
+    if (v && pred)
+    {
+        int size = v -> size(v);
+        if (!v -> members.items || start < 0 || end > size || start > end)
+        {
+            return removes;
+        }
+
+        size_t item_size = v -> get_item_size(v);
+        int last = end;
+        int i = start;
+        while (i < last)
+        {
+            if (pred(item_address(v, i), context))
+            {
+                last--;
+                if (i < last)
+                {
+                    copy(item_address(v, i), item_address(v, last), item_size);
+                }
+            }
+            else
             {
-                void* source = v -> members.items + j;
-                void* destination = v -> members.items + first_one;
-                copy(destination, source, value_size);
-                first_one++;
+                i++;
             }
         }
-        v -> resize(v, count_zero);
-        removes = size - count_zero;
+
+        removes = end - last;
+        if (removes > 0 && end < size)
+        {
+            move(item_address(v, last), item_address(v, end), (size_t) (size - end) * item_size);
+        }
+        v -> resize(v, size - removes);
     }
     return removes;
 }
 
+/**
+ * Makes room for at least the given number of elements
+ *
+ * @param v pointer to the vector
+ * @param new_capacity minimum capacity to guarantee
+ * @return status
+ */
+int vreserve(vector* v, int new_capacity)
+{
+    int status = FAILURE;
+    if (v)
+    {
+        if (new_capacity < 0)
+        {
+            return status;
+        }
+
+        status = SUCCESS;
+        if (new_capacity > v -> capacity(v))
+        {
+            status = update_capacity(v, new_capacity);
+        }
+    }
+    return status;
+}
+
 /**
  * Reversed end iterator (points a chunk of memory before
- * the first element
+ * the first element. Deprecated: C doesn't allow that address to be
+ * formed, vector_span_reverse in vector_span.h walks the vector backwards
+ * without it
  *
  * @param v pointer to the vector
  * @return address of the chunk before the first element
@@ -909,7 +1508,7 @@ void* vrend(vector* v)
     void* value = NULL;
     if (v)
     {
-        value = v -> begin(v) - sizeof(void*);
+        value = v -> begin(v) - v -> get_item_size(v);
     }
     return value;
 }
@@ -931,11 +1530,15 @@ int vresize(vector* v, int new_size)
             return status;
         }
 
-        v -> members.size = new_size;
         status = SUCCESS;
         if (new_size > v -> capacity(v))
         {
-            status = update_capacity(v, new_size * 2 + VECTOR_INIT_CAPACITY);
+            status = update_capacity(v, grown_capacity(v, new_size));
+        }
+        if (status == SUCCESS)
+        {
+            v -> members.size = new_size;
+            VECTOR_STATS_PEAK(v);
         }
     }
     return status;
@@ -952,7 +1555,100 @@ int vshrink(vector* v)
     int status = FAILURE;
     if (v)
     {
-        status = update_capacity(v, v -> size(v));
+        status = update_capacity(v, max(v -> size(v), VECTOR_INIT_CAPACITY));
+    }
+    return status;
+}
+
+/**
+ * Sets the growth policy used when the vector runs out of capacity
+ *
+ * @param v pointer to the vector
+ * @param growth_factor factor the capacity is multiplied by (> 1)
+ * @param min_chunk minimum number of elements added on each growth (> 0)
+ * @return status
+ */
+int vset_growth(vector* v, double growth_factor, int min_chunk)
+{
+    int status = FAILURE;
+    if (v && growth_factor > 1.0 && min_chunk > 0)
+    {
+        v -> members.growth_factor = growth_factor;
+        v -> members.min_chunk = min_chunk;
+        status = SUCCESS;
+    }
+    return status;
+}
+
+/**
+ * Sorts the elements. Packed vectors of 4 and 8 byte integers ordered by
+ * compare_int, compare_unsigned, compare_long_long or
+ * compare_unsigned_long_long are radix sorted, anything else goes through
+ * introsort
+ *
+ * @param v pointer to the vector
+ * @param cmp comparator
+ * @return status
+ */
+int vsort(vector* v, comparator cmp)
+{
+    VECTOR_STATS_START(start);
+    int status = FAILURE;
+    if (v && cmp)
+    {
+        int is_signed;
+        size_t size = v -> size(v);
+        size_t item_size = v -> get_item_size(v);
+        if (size >= SORT_RADIX_THRESHOLD && item_size == (size_t) v -> get_type_size(v)
+            && radix_sortable(item_size, cmp, &is_signed))
+        {
+            status = v -> stable_sort(v, cmp);
+        }
+        if (status != SUCCESS)
+        {
+            quick_sort(v -> begin(v), size, item_size, cmp);
+            status = SUCCESS;
+        }
+        VECTOR_STATS_STOP(v, VECTOR_OP_SORT, start);
+    }
+    return status;
+}
+
+/**
+ * Sorts the elements, keeping equivalent ones in their original order, with
+ * radix sort (for the same cases as sort) or merge sort. Both need a scratch
+ * buffer as big as the elements, taken from the allocator of the vector
+ *
+ * @param v pointer to the vector
+ * @param cmp comparator
+ * @return status
+ */
+int vstable_sort(vector* v, comparator cmp)
+{
+    int status = FAILURE;
+    if (v && cmp)
+    {
+        size_t size = v -> size(v);
+        size_t item_size = v -> get_item_size(v);
+        size_t bytes = size * item_size;
+        allocator* a = &v -> members.allocator;
+        unsigned char* scratch = a -> alloc(a -> context, max(bytes, (size_t) 1));
+        if (!scratch)
+        {
+            return status;
+        }
+
+        int is_signed;
+        if (item_size == (size_t) v -> get_type_size(v) && radix_sortable(item_size, cmp, &is_signed))
+        {
+            radix_sort(v -> begin(v), size, item_size, is_signed, scratch);
+        }
+        else
+        {
+            merge_sort(v -> begin(v), size, item_size, cmp, scratch);
+        }
+        a -> free(a -> context, scratch, max(bytes, (size_t) 1));
+        status = SUCCESS;
     }
     return status;
 }
@@ -974,55 +1670,95 @@ int vsize(vector* v)
 }
 
 /**
- * Vector initialization function
+ * Returns the index of the first element coming after value, in the vector
+ * sorted by cmp
  *
- * @param v v pointer to the vector
- * @param item_size size of the elements
+ * @param v pointer to the vector
+ * @param value to look for
+ * @param cmp comparator the vector is sorted by
+ * @return index between 0 and size
+ */
+int vupper_bound(vector* v, const void* value, comparator cmp)
+{
+    int index = VALUE_ERROR;
+    if (v && value && cmp)
+    {
+        index = (int) upper_bound(v -> begin(v), v -> size(v), v -> get_item_size(v), value, cmp);
+    }
+    return index;
+}
+
+/**
+ * Initializes methods and members of the vector with the given layout
+ *
+ * @param v pointer to the vector
+ * @param type_size size of the type of data stored
+ * @param item_size distance in bytes between two consecutive elements
+ * @param initialSize number of elements
  * @param initialCapacity allocated amount memory for elements
+ * @param alloc allocator owning the storage, NULL for the heap
  */
-void vector_init(vector *v, int type_size, int initialSize, int initialCapacity)
+void vector_init_layout(vector* v, int type_size, int item_size, int initialSize, int initialCapacity,
+                        const allocator* alloc)
 {
     if (v)
     {
         // Methods
+        v -> append = vappend;
         v -> assign = vassign;
+        v -> assign_range = vassign_range;
         v -> at = vat;
         v -> back = vback;
         v -> begin = vbegin;
+        v -> binary_search = vbinary_search;
         v -> capacity = vcapacity;
         v -> clear = vclear;
         v -> count = vcount;
         v -> empty = vempty;
         v -> end = vend;
         v -> erase_element = verase_element;
+        v -> erase_if = verase_if;
         v -> erase_index = verase_index;
+        v -> erase_range = verase_range;
         v -> fill = vfill;
         v -> find = vfind;
         v -> free = vfree;
         v -> front = vfront;
         v -> get_item_size = vget_item_size;
         v -> get_type_size = vget_type_size;
+        v -> get_reallocations = vget_reallocations;
         v -> insert = vinsert;
+        v -> insert_range = vinsert_range;
+        v -> lower_bound = vlower_bound;
+        v -> nth_element = vnth_element;
+        v -> partial_sort = vpartial_sort;
         v -> pop_back = vpop_back;
         v -> push_back = vpush_back;
         v -> rbegin = vrbegin;
         v -> remove_if = vremove_if;
+        v -> remove_if_unordered = vremove_if_unordered;
         v -> rend = vrend;
+        v -> reserve = vreserve;
         v -> resize = vresize;
+        v -> set_growth = vset_growth;
         v -> shrink = vshrink;
         v -> size = vsize;
+        v -> sort = vsort;
+        v -> stable_sort = vstable_sort;
+        v -> upper_bound = vupper_bound;
 
         // Members
-        v -> members.item_size = VECTOR_DEFAULT_ITEMSIZE;
-
-        if (type_size > 0)
-        {
-            v -> members.type_size = type_size;
-        }
-        else
-        {
-            v -> members.type_size = VECTOR_DEFAULT_TYPESIZE;
-        }
+        v -> members.type_size = type_size;
+        v -> members.item_size = item_size;
+        v -> members.growth_factor = VECTOR_DEFAULT_GROWTH_FACTOR;
+        v -> members.min_chunk = VECTOR_DEFAULT_MIN_CHUNK;
+        v -> members.reallocations = 0;
+        v -> members.allocator = alloc ? *alloc : heap_allocator();
+        v -> members.inline_bytes = VECTOR_INLINE_BYTES;
+#ifdef VECTOR_STATS
+        vector_stats empty = { 0 };
+        v -> members.stats = empty;
+#endif
 
         if (initialSize > 0)
         {
@@ -1046,14 +1782,250 @@ void vector_init(vector *v, int type_size, int initialSize, int initialCapacity)
         int capacity = v -> capacity(v);
         if (size > capacity)
         {
-            v -> members.capacity = size + 1;
+            capacity = size + 1;
         }
 
-        v -> members.items = malloc(capacity * sizeof(void*));
+        v -> members.items = NULL;
+        v -> members.size = VECTOR_INIT_SIZE;
+        update_capacity(v, capacity);
+        v -> members.size = size;
+        v -> members.reallocations = 0;
 
         int value = 0;
         set(v -> begin(v), v -> end(v), &value, sizeof(value));
     }
 }
 
+/**
+ * Vector initialization function. Every element is stored in a slot of
+ * VECTOR_DEFAULT_ITEMSIZE bytes (or a multiple of it for bigger types)
+ *
+ * @param v v pointer to the vector
+ * @param type_size size of the type of data stored
+ * @param initialSize number of elements
+ * @param initialCapacity allocated amount memory for elements
+ */
+void vector_init(vector *v, int type_size, int initialSize, int initialCapacity)
+{
+    if (type_size <= 0)
+    {
+        type_size = VECTOR_DEFAULT_TYPESIZE;
+    }
+
+    int slots = (type_size + VECTOR_DEFAULT_ITEMSIZE - 1) / VECTOR_DEFAULT_ITEMSIZE;
+    vector_init_layout(v, type_size, slots * VECTOR_DEFAULT_ITEMSIZE, initialSize, initialCapacity, NULL);
+}
+
+/**
+ * Packed vector initialization function. Elements are stored contiguously
+ * at type_size stride, like a plain C array of the stored type, so they keep
+ * the alignment of the type (allocators return memory suitably aligned for any
+ * type and sizeof(T) is always a multiple of the alignment of T)
+ *
+ * @param v v pointer to the vector
+ * @param type_size size of the type of data stored
+ * @param initialSize number of elements
+ * @param initialCapacity allocated amount memory for elements
+ */
+void vector_init_packed(vector* v, int type_size, int initialSize, int initialCapacity)
+{
+    if (type_size <= 0)
+    {
+        type_size = VECTOR_DEFAULT_TYPESIZE;
+    }
+
+    vector_init_layout(v, type_size, type_size, initialSize, initialCapacity, NULL);
+}
+
+/**
+ * Vector initialization function drawing its storage from the given
+ * allocator, with the layout of vector_init
+ *
+ * @param v v pointer to the vector
+ * @param type_size size of the type of data stored
+ * @param initialSize number of elements
+ * @param initialCapacity allocated amount memory for elements
+ * @param alloc allocator owning the storage, NULL for the heap
+ */
+void vector_init_allocator(vector* v, int type_size, int initialSize, int initialCapacity, const allocator* alloc)
+{
+    if (type_size <= 0)
+    {
+        type_size = VECTOR_DEFAULT_TYPESIZE;
+    }
+
+    int slots = (type_size + VECTOR_DEFAULT_ITEMSIZE - 1) / VECTOR_DEFAULT_ITEMSIZE;
+    vector_init_layout(v, type_size, slots * VECTOR_DEFAULT_ITEMSIZE, initialSize, initialCapacity, alloc);
+}
+
+/**
+ * Packed vector initialization function drawing its storage from the given
+ * allocator, with the layout of vector_init_packed
+ *
+ * @param v v pointer to the vector
+ * @param type_size size of the type of data stored
+ * @param initialSize number of elements
+ * @param initialCapacity allocated amount memory for elements
+ * @param alloc allocator owning the storage, NULL for the heap
+ */
+void vector_init_packed_allocator(vector* v, int type_size, int initialSize, int initialCapacity,
+                                  const allocator* alloc)
+{
+    if (type_size <= 0)
+    {
+        type_size = VECTOR_DEFAULT_TYPESIZE;
+    }
+
+    vector_init_layout(v, type_size, type_size, initialSize, initialCapacity, alloc);
+}
+
+/**
+ * Points items of a vector whose members were copied from another one to
+ * its own inline buffer, when they pointed to the inline buffer of the other
+ */
+void vector_fix_inline(vector* v, const vector* from)
+{
+    if (v -> members.items == (const void*) from -> members.inline_buffer)
+    {
+        v -> members.items = v -> members.inline_buffer;
+    }
+}
+
+/**
+ * Takes ownership of an existing array, which becomes the storage of the
+ * vector without copying it. The previous storage is released. The array
+ * must come from the allocator of the vector (malloc for the heap one) and
+ * hold its elements at item_size stride. The current storage of the vector
+ * cannot be adopted again
+ *
+ * @param v pointer to the vector
+ * @param buffer array to adopt
+ * @param count number of elements in the array
+ * @param capacity number of elements the array has room for
+ * @return status
+ */
+int vector_adopt(vector* v, void* buffer, int count, int capacity)
+{
+    int status = FAILURE;
+    if (!v || !buffer || count < 0 || capacity <= 0 || count > capacity || buffer == v -> members.items)
+    {
+        return status;
+    }
+    if (v -> members.items && !is_inline(v))
+    {
+        allocator* a = &v -> members.allocator;
+        a -> free(a -> context, v -> members.items, (size_t) v -> members.capacity * v -> members.item_size);
+    }
+    v -> members.items = buffer;
+    v -> members.size = count;
+    v -> members.capacity = capacity;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Detaches the storage from the vector and hands it to the caller, who
+ * releases it with the allocator of the vector (free for the heap one).
+ * Elements in the inline buffer are first copied to an allocated array.
+ * The vector is left empty and usable
+ *
+ * @param v pointer to the vector
+ * @param count receiving the number of elements, may be NULL
+ * @param capacity receiving the number of elements the array has room for,
+ *                 may be NULL
+ * @return array of the elements at item_size stride, NULL on failure
+ */
+void* vector_release(vector* v, int* count, int* capacity)
+{
+    if (!v)
+    {
+        return NULL;
+    }
+
+    void* buffer = v -> members.items;
+    if (is_inline(v))
+    {
+        allocator* a = &v -> members.allocator;
+        size_t bytes = (size_t) v -> members.capacity * v -> members.item_size;
+        buffer = a -> alloc(a -> context, bytes);
+        if (!buffer)
+        {
+            return NULL;
+        }
+        copy(buffer, v -> members.items, (size_t) v -> members.size * v -> members.item_size);
+    }
+    if (count)
+    {
+        *count = v -> members.size;
+    }
+    if (capacity)
+    {
+        *capacity = v -> members.capacity;
+    }
+    v -> members.items = NULL;
+    v -> members.size = VECTOR_INIT_SIZE;
+    update_capacity(v, VECTOR_INIT_CAPACITY);
+    return buffer;
+}
+
+/**
+ * Exchanges the content of two vectors in constant time, storage,
+ * allocator and growth policy included. Only inline elements are copied
+ *
+ * @param a pointer to a vector
+ * @param b pointer to a vector
+ * @return status
+ */
+int vector_swap(vector* a, vector* b)
+{
+    int status = FAILURE;
+    if (!a || !b)
+    {
+        return status;
+    }
+    if (a != b)
+    {
+        members temp = a -> members;
+        a -> members = b -> members;
+        b -> members = temp;
+        vector_fix_inline(a, b);
+        vector_fix_inline(b, a);
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Moves the content of src into dst in constant time, releasing the
+ * previous storage of dst. src is left empty and usable
+ *
+ * @param dst pointer to the vector receiving the content
+ * @param src pointer to the vector giving it
+ * @return status
+ */
+int vector_move(vector* dst, vector* src)
+{
+    int status = FAILURE;
+    if (!dst || !src)
+    {
+        return status;
+    }
+    if (dst != src)
+    {
+        if (dst -> members.items && !is_inline(dst))
+        {
+            allocator* a = &dst -> members.allocator;
+            a -> free(a -> context, dst -> members.items, (size_t) dst -> members.capacity * dst -> members.item_size);
+        }
+        dst -> members = src -> members;
+        vector_fix_inline(dst, src);
+        src -> members.items = NULL;
+        src -> members.size = VECTOR_INIT_SIZE;
+        src -> members.reallocations = 0;
+        update_capacity(src, VECTOR_INIT_CAPACITY);
+    }
+    status = SUCCESS;
+    return status;
+}
+
 #endif
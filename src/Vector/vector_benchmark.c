@@ -0,0 +1,482 @@
+/**
+ * @file    vector_benchmark.c - Microbenchmarks for the vector and the utilities kernels
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ *
+ * Usage: vector_benchmark [--format csv|json] [--min-size N] [--max-size N]
+ *
+ * Every operation is measured on packed vectors of 1, 4, 8, 16 and 64 byte
+ * elements, for sizes going from min-size to max-size (powers of ten,
+ * default 1e2 to 1e6, up to 1e8). Each result reports the time per
+ * operation, the bytes requested to the allocator per operation and the
+ * throughput in operations and in bytes per second.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "./vector.h"
+
+#define BENCH_MIN_SIZE 100LL
+#define BENCH_MAX_SIZE 1000000LL
+#define BENCH_SIZE_LIMIT 100000000LL
+#define BENCH_SHIFT_OPS 1000LL
+#define BENCH_SCAN_ELEMENTS 10000000LL
+#define BENCH_MAX_TYPE_SIZE 64
+
+/**
+ * Output formats
+ */
+enum bench_format {
+    FORMAT_CSV,
+    FORMAT_JSON
+};
+
+/**
+ * Measurement of one operation
+ */
+typedef struct bench_result {
+
+    /**
+     * Name of the operation
+     */
+    const char* operation;
+
+    /**
+     * Size of an element in bytes
+     */
+    int type_size;
+
+    /**
+     * Number of elements in the vector
+     */
+    long long size;
+
+    /**
+     * Number of operations measured
+     */
+    long long ops;
+
+    /**
+     * Elapsed time in nanoseconds
+     */
+    double ns;
+
+    /**
+     * Bytes requested to the allocator of the vector during the measure
+     */
+    long long bytes_allocated;
+
+    /**
+     * Bytes of elements touched during the measure
+     */
+    long long bytes_touched;
+
+} bench_result;
+
+static int format = FORMAT_CSV;
+static int results_printed = 0;
+
+/**
+ * Returns a monotonic timestamp in nanoseconds
+ */
+double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * Context of the allocator of the measured vectors: the heap allocator it
+ * forwards to and the bytes requested through it
+ */
+typedef struct counting_context {
+    allocator heap;
+    long long bytes;
+} counting_context;
+
+static counting_context counting = { { heap_alloc, heap_realloc, heap_free, NULL }, 0 };
+
+/**
+ * Allocates on the heap, counting the bytes requested
+ */
+void* counting_alloc(void* context, size_t size)
+{
+    counting_context* c = context;
+    c -> bytes += size;
+    return c -> heap.alloc(c -> heap.context, size);
+}
+
+/**
+ * Resizes on the heap, counting the bytes requested
+ */
+void* counting_realloc(void* context, void* ptr, size_t old_size, size_t new_size)
+{
+    counting_context* c = context;
+    c -> bytes += new_size;
+    return c -> heap.realloc(c -> heap.context, ptr, old_size, new_size);
+}
+
+/**
+ * Releases on the heap
+ */
+void counting_free(void* context, void* ptr, size_t size)
+{
+    counting_context* c = context;
+    c -> heap.free(c -> heap.context, ptr, size);
+}
+
+/**
+ * Returns the heap allocator counting the bytes requested in counting.bytes
+ */
+allocator counting_allocator()
+{
+    allocator a = { counting_alloc, counting_realloc, counting_free, &counting };
+    return a;
+}
+
+/**
+ * Creates an empty packed vector allocating through counting_allocator
+ */
+void make_empty_vector(vector* v, int type_size)
+{
+    allocator a = counting_allocator();
+    vector_init_packed_allocator(v, type_size, 0, 0, &a);
+}
+
+/**
+ * Writes a recognizable value of type_size bytes derived from seed
+ */
+void make_value(unsigned char* value, int type_size, long long seed)
+{
+    int i;
+    for (i = 0; i < type_size; ++i)
+    {
+        value[i] = (unsigned char) (seed >> (8 * (i % 8)));
+    }
+}
+
+/**
+ * Creates a packed vector holding size elements
+ */
+void make_vector(vector* v, int type_size, long long size)
+{
+    unsigned char value[BENCH_MAX_TYPE_SIZE];
+    make_empty_vector(v, type_size);
+    v -> reserve(v, (int) size);
+    long long i;
+    for (i = 0; i < size; ++i)
+    {
+        make_value(value, type_size, i % 251);
+        v -> push_back(v, value);
+    }
+}
+
+/**
+ * Releases the storage of the vector, which goes back to its inline buffer
+ */
+void destroy_vector(vector* v)
+{
+    v -> free(v);
+}
+
+/**
+ * Prints one result in the selected format
+ */
+void report(bench_result* r)
+{
+    double ns_per_op = r -> ns / r -> ops;
+    double seconds = r -> ns / 1e9;
+    double ops_per_s = seconds > 0 ? r -> ops / seconds : 0;
+    double mb_per_s = seconds > 0 ? r -> bytes_touched / seconds / 1e6 : 0;
+    double bytes_per_op = (double) r -> bytes_allocated / r -> ops;
+
+    if (format == FORMAT_JSON)
+    {
+        printf("%s\n  {\"operation\": \"%s\", \"type_size\": %d, \"size\": %lld, \"ops\": %lld, "
+               "\"ns_per_op\": %.3f, \"bytes_per_op\": %.3f, \"ops_per_s\": %.1f, \"mb_per_s\": %.1f}",
+               results_printed ? "," : "[", r -> operation, r -> type_size, r -> size, r -> ops,
+               ns_per_op, bytes_per_op, ops_per_s, mb_per_s);
+    }
+    else
+    {
+        if (!results_printed)
+        {
+            printf("operation,type_size,size,ops,ns_per_op,bytes_per_op,ops_per_s,mb_per_s\n");
+        }
+        printf("%s,%d,%lld,%lld,%.3f,%.3f,%.1f,%.1f\n", r -> operation, r -> type_size, r -> size,
+               r -> ops, ns_per_op, bytes_per_op, ops_per_s, mb_per_s);
+    }
+    results_printed++;
+    fflush(stdout);
+}
+
+/**
+ * Number of repetitions of a full scan so that every measure touches
+ * roughly BENCH_SCAN_ELEMENTS elements
+ */
+long long scan_repetitions(long long size)
+{
+    return max(1LL, BENCH_SCAN_ELEMENTS / size);
+}
+
+/**
+ * Measures push_back of size elements into an empty vector
+ */
+void bench_push_back(int type_size, long long size)
+{
+    unsigned char value[BENCH_MAX_TYPE_SIZE];
+    make_value(value, type_size, 7);
+    vector v;
+    make_empty_vector(&v, type_size);
+    counting.bytes = 0;
+
+    double start = now_ns();
+    long long i;
+    for (i = 0; i < size; ++i)
+    {
+        v.push_back(&v, value);
+    }
+    double elapsed = now_ns() - start;
+
+    bench_result r = { "push_back", type_size, size, size, elapsed,
+                       counting.bytes, size * type_size };
+    report(&r);
+    destroy_vector(&v);
+}
+
+/**
+ * Measures single-element inserts at the front or in the middle
+ */
+void bench_insert(const char* name, int type_size, long long size, int middle)
+{
+    unsigned char value[BENCH_MAX_TYPE_SIZE];
+    make_value(value, type_size, 7);
+    vector v;
+    make_vector(&v, type_size, size);
+    long long ops = min(size, BENCH_SHIFT_OPS);
+    counting.bytes = 0;
+
+    double start = now_ns();
+    long long i;
+    for (i = 0; i < ops; ++i)
+    {
+        v.insert(&v, value, middle ? v.size(&v) / 2 : 0);
+    }
+    double elapsed = now_ns() - start;
+
+    bench_result r = { name, type_size, size, ops, elapsed,
+                       counting.bytes, ops * (size + ops / 2) * type_size / (middle ? 2 : 1) };
+    report(&r);
+    destroy_vector(&v);
+}
+
+/**
+ * Measures single-element erases at the front or in the middle
+ */
+void bench_erase(const char* name, int type_size, long long size, int middle)
+{
+    vector v;
+    make_vector(&v, type_size, size);
+    long long ops = min(size, BENCH_SHIFT_OPS);
+    counting.bytes = 0;
+
+    double start = now_ns();
+    long long i;
+    for (i = 0; i < ops; ++i)
+    {
+        v.erase_index(&v, middle ? v.size(&v) / 2 : 0);
+    }
+    double elapsed = now_ns() - start;
+
+    bench_result r = { name, type_size, size, ops, elapsed,
+                       counting.bytes, ops * (size - ops / 2) * type_size / (middle ? 2 : 1) };
+    report(&r);
+    destroy_vector(&v);
+}
+
+/**
+ * Measures the full scans: find (of a missing value), count and fill
+ */
+void bench_scan(const char* name, int type_size, long long size)
+{
+    unsigned char value[BENCH_MAX_TYPE_SIZE];
+    // 255 is never produced by make_vector, so find and count scan everything
+    make_value(value, type_size, 255);
+    vector v;
+    make_vector(&v, type_size, size);
+    long long ops = scan_repetitions(size);
+    counting.bytes = 0;
+    volatile int sink = 0;
+
+    // The method is picked once, outside of the measure
+    int (*scan)(vector*, const void*) = v.fill;
+    if (!strcmp(name, "find"))
+    {
+        scan = v.find;
+    }
+    else if (!strcmp(name, "count"))
+    {
+        scan = v.count;
+    }
+
+    double start = now_ns();
+    long long i;
+    for (i = 0; i < ops; ++i)
+    {
+        sink += scan(&v, value);
+    }
+    double elapsed = now_ns() - start;
+    (void) sink;
+
+    bench_result r = { name, type_size, size, ops, elapsed,
+                       counting.bytes, ops * size * type_size };
+    report(&r);
+    destroy_vector(&v);
+}
+
+/**
+ * Matches the elements whose first byte is even, which is half of them
+ */
+int first_byte_even(const void* element, void* context)
+{
+    (void) context;
+    return (*(const unsigned char*) element % 2) == 0;
+}
+
+/**
+ * Measures a remove_if dropping half of the elements
+ */
+void bench_remove_if(int type_size, long long size)
+{
+    vector v;
+    make_vector(&v, type_size, size);
+    counting.bytes = 0;
+
+    double start = now_ns();
+    v.remove_if(&v, 0, (int) size, first_byte_even, NULL);
+    double elapsed = now_ns() - start;
+
+    bench_result r = { "remove_if", type_size, size, 1, elapsed,
+                       counting.bytes, size * type_size };
+    report(&r);
+    destroy_vector(&v);
+}
+
+/**
+ * Measures a shrink releasing half of the capacity
+ */
+void bench_shrink(int type_size, long long size)
+{
+    vector v;
+    make_vector(&v, type_size, size);
+    v.reserve(&v, (int) (size * 2));
+    counting.bytes = 0;
+
+    double start = now_ns();
+    v.shrink(&v);
+    double elapsed = now_ns() - start;
+
+    bench_result r = { "shrink", type_size, size, 1, elapsed,
+                       counting.bytes, size * type_size };
+    report(&r);
+    destroy_vector(&v);
+}
+
+/**
+ * Measures copy, move, compare and set on buffers of the given size
+ */
+void bench_kernels(long long size)
+{
+    unsigned char* a = calloc(size + 1, 1);
+    unsigned char* b = calloc(size + 1, 1);
+    if (!a || !b)
+    {
+        free(a);
+        free(b);
+        return;
+    }
+    int value = 42;
+    long long ops = scan_repetitions(size);
+    volatile int sink = 0;
+    const char* names[] = { "kernel_copy", "kernel_move", "kernel_compare", "kernel_set" };
+    int k;
+    for (k = 0; k < 4; ++k)
+    {
+        double start = now_ns();
+        long long i;
+        for (i = 0; i < ops; ++i)
+        {
+            switch (k)
+            {
+                case 0: sink += copy(b, a, size); break;
+                case 1: sink += move(a + 1, a, size); break;
+                case 2: sink += compare(a, b, (int) size); break;
+                default: sink += set(a, a + size, &value, sizeof(value)); break;
+            }
+        }
+        double elapsed = now_ns() - start;
+        bench_result r = { names[k], 1, size, ops, elapsed, 0, ops * size };
+        report(&r);
+    }
+    (void) sink;
+    free(a);
+    free(b);
+}
+
+int main(int argc, char** argv)
+{
+    long long min_size = BENCH_MIN_SIZE;
+    long long max_size = BENCH_MAX_SIZE;
+    int i;
+    for (i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--format"))
+        {
+            format = strcmp(argv[i + 1], "json") ? FORMAT_CSV : FORMAT_JSON;
+        }
+        else if (!strcmp(argv[i], "--min-size"))
+        {
+            min_size = atoll(argv[i + 1]);
+        }
+        else if (!strcmp(argv[i], "--max-size"))
+        {
+            max_size = atoll(argv[i + 1]);
+        }
+    }
+    min_size = max(min_size, 1LL);
+    max_size = min(max_size, BENCH_SIZE_LIMIT);
+
+    const int type_sizes[] = { 1, 4, 8, 16, 64 };
+    long long size;
+    for (size = min_size; size <= max_size; size *= 10)
+    {
+        int t;
+        for (t = 0; t < (int) (sizeof(type_sizes) / sizeof(type_sizes[0])); ++t)
+        {
+            int type_size = type_sizes[t];
+            bench_push_back(type_size, size);
+            bench_insert("insert_front", type_size, size, false);
+            bench_insert("insert_middle", type_size, size, true);
+            bench_erase("erase_front", type_size, size, false);
+            bench_erase("erase_middle", type_size, size, true);
+            bench_scan("find", type_size, size);
+            bench_scan("count", type_size, size);
+            bench_scan("fill", type_size, size);
+            bench_remove_if(type_size, size);
+            bench_shrink(type_size, size);
+        }
+        bench_kernels(size);
+    }
+
+    if (format == FORMAT_JSON)
+    {
+        printf("%s]\n", results_printed ? "\n" : "[");
+    }
+
+    return 0;
+}
@@ -0,0 +1,384 @@
+/**
+ * @file    vector_file.h - Vector whose storage is a memory-mapped file
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_FILE_H
+#define VECTOR_FILE_H
+
+#pragma once
+
+// mremap is a GNU extension, it is only used when this is the first include
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "./vector.h"
+
+/**
+ * First bytes of every vector file
+ */
+#define VECTOR_FILE_MAGIC 0x31454c4946434556ULL
+
+#define VECTOR_FILE_VERSION 1
+
+/**
+ * Bytes reserved for the header before the elements
+ */
+#define VECTOR_FILE_HEADER_SIZE 64
+
+/**
+ * Header at the beginning of a vector file
+ */
+typedef struct vector_file_header {
+
+    /**
+     * VECTOR_FILE_MAGIC
+     */
+    uint64_t magic;
+
+    /**
+     * VECTOR_FILE_VERSION
+     */
+    uint32_t version;
+
+    /**
+     * Size of the value pointed by an element in Bytes
+     */
+    int32_t type_size;
+
+    /**
+     * Distance between two consecutive elements in Bytes
+     */
+    int32_t item_size;
+
+    /**
+     * Number of elements, as of the last sync
+     */
+    int32_t size;
+
+    /**
+     * Number of elements the file has room for
+     */
+    int32_t capacity;
+
+} vector_file_header;
+
+/**
+ * Mapping of a vector file. Used as the context of the allocator of the
+ * vector, which grows the file instead of the heap
+ */
+typedef struct vector_file {
+
+    /**
+     * Descriptor of the file
+     */
+    int fd;
+
+    /**
+     * Start of the mapping, where the header is
+     */
+    unsigned char* base;
+
+    /**
+     * Length of the mapping and of the file in Bytes
+     */
+    size_t length;
+
+} vector_file;
+
+/**
+ * Returns the header of a mapped file
+ */
+vector_file_header* vector_file_get_header(vector_file* f)
+{
+    return (vector_file_header*) f -> base;
+}
+
+/**
+ * Resizes the file to hold the header and size bytes of elements and maps
+ * it again. The kernel moves the mapping if it cannot grow in place, the
+ * pages of the file are never copied
+ *
+ * @return status
+ */
+int vector_file_map(vector_file* f, size_t size)
+{
+    int status = FAILURE;
+    size_t length = VECTOR_FILE_HEADER_SIZE + size;
+    if (ftruncate(f -> fd, (off_t) length) != 0)
+    {
+        return status;
+    }
+
+    void* base;
+    if (!f -> base)
+    {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, f -> fd, 0);
+    }
+    else
+    {
+#ifdef MREMAP_MAYMOVE
+        base = mremap(f -> base, f -> length, length, MREMAP_MAYMOVE);
+#else
+        munmap(f -> base, f -> length);
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, f -> fd, 0);
+#endif
+    }
+    if (base == MAP_FAILED)
+    {
+        return status;
+    }
+    f -> base = base;
+    f -> length = length;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Resizes the elements area of the file
+ *
+ * @param context pointer to the vector_file
+ * @param ptr current elements area, ignored
+ * @param old_size current size of the area
+ * @param new_size requested size
+ * @return pointer to the elements area, NULL on failure
+ */
+void* vector_file_realloc(void* context, void* ptr, size_t old_size, size_t new_size)
+{
+    vector_file* f = context;
+    (void) ptr;
+    (void) old_size;
+    if (!f || !f -> base || vector_file_get_header(f) -> item_size <= 0 ||
+        vector_file_map(f, new_size) != SUCCESS)
+    {
+        return NULL;
+    }
+    vector_file_header* header = vector_file_get_header(f);
+    header -> capacity = (int32_t) (new_size / header -> item_size);
+    return f -> base + VECTOR_FILE_HEADER_SIZE;
+}
+
+/**
+ * Sets the size of the elements area of the file
+ *
+ * @param context pointer to the vector_file
+ * @param size requested size
+ * @return pointer to the elements area, NULL on failure
+ */
+void* vector_file_alloc(void* context, size_t size)
+{
+    return vector_file_realloc(context, NULL, 0, size);
+}
+
+/**
+ * The mapping is released by vector_file_close only
+ */
+void vector_file_release(void* context, void* ptr, size_t size)
+{
+    (void) context;
+    (void) ptr;
+    (void) size;
+}
+
+/**
+ * Frees the heap storage the vector got from its initialization and leaves
+ * it without elements
+ */
+void vector_file_drop_storage(vector* v)
+{
+    allocator* a = &v -> members.allocator;
+    if (v -> members.items && !is_inline(v))
+    {
+        a -> free(a -> context, v -> members.items, (size_t) v -> members.capacity * v -> members.item_size);
+    }
+    v -> members.items = NULL;
+    v -> members.size = 0;
+    v -> members.capacity = 0;
+}
+
+/**
+ * Unmaps and closes a file which could not be opened as a vector
+ *
+ * @return FAILURE
+ */
+int vector_file_discard(vector* v, vector_file* f)
+{
+    if (f -> base)
+    {
+        munmap(f -> base, f -> length);
+    }
+    if (f -> fd >= 0)
+    {
+        close(f -> fd);
+    }
+    free(f);
+    vector_file_drop_storage(v);
+    return FAILURE;
+}
+
+/**
+ * Makes a validated file the storage of the vector, which from now on grows
+ * the file instead of the heap
+ */
+void vector_file_attach(vector* v, vector_file* f)
+{
+    vector_file_drop_storage(v);
+    allocator alloc = { vector_file_alloc, vector_file_realloc, vector_file_release, f };
+    vector_file_header* header = vector_file_get_header(f);
+    v -> members.allocator = alloc;
+    v -> members.inline_bytes = 0;
+    v -> members.items = f -> base + VECTOR_FILE_HEADER_SIZE;
+    v -> members.capacity = header -> capacity;
+    v -> members.size = header -> size;
+}
+
+/**
+ * Checks that the header of an existing file describes elements of
+ * type_size bytes fitting in the file
+ */
+int vector_file_valid(vector_file* f, int type_size)
+{
+    vector_file_header* header = vector_file_get_header(f);
+    return header -> magic == VECTOR_FILE_MAGIC && header -> version == VECTOR_FILE_VERSION &&
+           header -> type_size == type_size && header -> item_size == type_size &&
+           header -> size >= 0 && header -> size <= header -> capacity &&
+           VECTOR_FILE_HEADER_SIZE + (size_t) header -> capacity * header -> item_size <= f -> length;
+}
+
+/**
+ * Opens a vector stored in a file, creating the file when it doesn't exist.
+ * An existing file is mapped as it is and the vector is usable right away,
+ * with the size it had at the last sync. Its elements are laid out as in
+ * vector_init_packed.
+ *
+ * The vector never uses its inline buffer and must be released with
+ * vector_file_close instead of free
+ *
+ * @param v pointer to the vector
+ * @param path of the file
+ * @param type_size size of an element in Bytes, must match an existing file
+ * @return status
+ */
+int vector_file_open(vector* v, const char* path, int type_size)
+{
+    int status = FAILURE;
+    if (!v || !path || type_size <= 0)
+    {
+        return status;
+    }
+
+    vector_file* f = malloc(sizeof(vector_file));
+    if (!f)
+    {
+        return status;
+    }
+    f -> base = NULL;
+    f -> length = 0;
+    f -> fd = open(path, O_RDWR | O_CREAT, 0644);
+
+    // The file is checked before it becomes the storage, nothing is resized
+    // until the header is known to be valid
+    vector_init_layout(v, type_size, type_size, 0, 0, NULL);
+
+    struct stat st;
+    if (f -> fd < 0 || fstat(f -> fd, &st) != 0)
+    {
+        return vector_file_discard(v, f);
+    }
+
+    if (st.st_size == 0)
+    {
+        if (vector_file_map(f, (size_t) type_size * VECTOR_INIT_CAPACITY) != SUCCESS)
+        {
+            return vector_file_discard(v, f);
+        }
+        vector_file_header* header = vector_file_get_header(f);
+        header -> magic = VECTOR_FILE_MAGIC;
+        header -> version = VECTOR_FILE_VERSION;
+        header -> type_size = type_size;
+        header -> item_size = type_size;
+        header -> size = 0;
+        header -> capacity = VECTOR_INIT_CAPACITY;
+    }
+    else
+    {
+        if ((size_t) st.st_size < VECTOR_FILE_HEADER_SIZE)
+        {
+            return vector_file_discard(v, f);
+        }
+        void* base = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, f -> fd, 0);
+        if (base == MAP_FAILED)
+        {
+            return vector_file_discard(v, f);
+        }
+        f -> base = base;
+        f -> length = (size_t) st.st_size;
+        if (!vector_file_valid(f, type_size))
+        {
+            return vector_file_discard(v, f);
+        }
+    }
+    vector_file_attach(v, f);
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Writes the size of the vector to the header and flushes the mapping to
+ * the file
+ *
+ * @param v pointer to a vector opened with vector_file_open
+ * @return status
+ */
+int vector_file_sync(vector* v)
+{
+    int status = FAILURE;
+    if (v && v -> members.items && v -> members.allocator.alloc == vector_file_alloc)
+    {
+        vector_file* f = v -> members.allocator.context;
+        vector_file_header* header = vector_file_get_header(f);
+        header -> size = v -> members.size;
+        header -> capacity = v -> members.capacity;
+        if (msync(f -> base, f -> length, MS_SYNC) == 0)
+        {
+            status = SUCCESS;
+        }
+    }
+    return status;
+}
+
+/**
+ * Syncs the vector, unmaps and closes its file
+ *
+ * @param v pointer to a vector opened with vector_file_open
+ * @return status
+ */
+int vector_file_close(vector* v)
+{
+    int status = FAILURE;
+    if (v && v -> members.items && v -> members.allocator.alloc == vector_file_alloc)
+    {
+        vector_file* f = v -> members.allocator.context;
+        status = vector_file_sync(v);
+        munmap(f -> base, f -> length);
+        close(f -> fd);
+        free(f);
+        v -> members.items = NULL;
+        v -> members.size = 0;
+        v -> members.capacity = 0;
+        v -> members.allocator = heap_allocator();
+    }
+    return status;
+}
+
+#endif
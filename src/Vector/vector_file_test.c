@@ -0,0 +1,85 @@
+/**
+ * @file    vector_file_test.c - Main program for testing the file-backed vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include "./vector_file.h"
+#include <stdio.h>
+
+/**
+ * Element bigger than the inline buffer of a vector
+ */
+typedef struct record {
+    long long id;
+    char payload[248];
+} record;
+
+int main()
+{
+    const char* path = "vector_file_test.bin";
+    unlink(path);
+
+    vector v;
+    int status = vector_file_open(&v, path, sizeof(long long));
+    printf("Create file:            (status %d)\n", status);
+
+    long long i;
+    for (i = 0; i < 100000; ++i)
+    {
+        status |= v.push_back(&v, &i);
+    }
+    printf("Push 100000 values:     (status %d)\n", status);
+    printf("Size:                       %6d\n", v.size(&v));
+    printf("Capacity:                   %6d\n", v.capacity(&v));
+    printf("Close:                  (status %d)\n", vector_file_close(&v));
+
+    status = vector_file_open(&v, path, sizeof(long long));
+    printf("Reopen file:            (status %d)\n", status);
+    printf("Size:                       %6d\n", v.size(&v));
+    printf("v[99999]:                   %6lld\n", *(long long*) v.at(&v, 99999));
+
+    i = 424242;
+    printf("Push back %lld:      (status %d)\n", i, v.push_back(&v, &i));
+    printf("Sync:                   (status %d)\n", vector_file_sync(&v));
+    printf("Close:                  (status %d)\n", vector_file_close(&v));
+
+    status = vector_file_open(&v, path, sizeof(int));
+    printf("Reopen wrong type:      (status %d)\n", status);
+
+    status = vector_file_open(&v, path, sizeof(long long));
+    printf("Reopen file:            (status %d)\n", status);
+    printf("Back:                       %6lld\n", *(long long*) v.back(&v));
+    printf("Close:                  (status %d)\n", vector_file_close(&v));
+
+    unlink(path);
+
+    status = vector_file_open(&v, path, sizeof(record));
+    printf("Create record file:     (status %d)\n", status);
+    record r = { 0 };
+    for (r.id = 0; r.id < 1000; ++r.id)
+    {
+        snprintf(r.payload, sizeof(r.payload), "record %lld", r.id);
+        status |= v.push_back(&v, &r);
+    }
+    printf("Push 1000 records:      (status %d)\n", status);
+    printf("Close:                  (status %d)\n", vector_file_close(&v));
+
+    status = vector_file_open(&v, path, sizeof(record));
+    printf("Reopen record file:     (status %d)\n", status);
+    printf("Size:                       %6d\n", v.size(&v));
+    printf("v[999]:               %s\n", ((record*) v.at(&v, 999)) -> payload);
+    printf("Close:                  (status %d)\n", vector_file_close(&v));
+
+    status = vector_file_open(&v, path, sizeof(long long));
+    printf("Reopen wrong type:      (status %d)\n", status);
+    status = vector_file_open(&v, path, sizeof(record));
+    printf("File kept:                  %6d\n", v.size(&v));
+    printf("Close:                  (status %d)\n", vector_file_close(&v) | status);
+
+    unlink(path);
+    return 0;
+}
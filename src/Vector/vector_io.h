@@ -0,0 +1,490 @@
+/**
+ * @file    vector_io.h - Binary serialization of vectors to streams
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_IO_H
+#define VECTOR_IO_H
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "./vector.h"
+
+#define VECTOR_IO_MAGIC "VSER"
+#define VECTOR_IO_VERSION 1
+#define VECTOR_IO_LITTLE_ENDIAN 1
+#define VECTOR_IO_BIG_ENDIAN 2
+
+/**
+ * Bytes of the header written before the elements
+ */
+#define VECTOR_IO_HEADER_SIZE 32
+
+/**
+ * Bytes moved at once when the elements are not packed in memory
+ */
+#define VECTOR_IO_CHUNK_BYTES (64 * 1024)
+
+/**
+ * Description of serialized elements, read from or written to the header.
+ * The header is always stored little endian, field by field
+ */
+typedef struct vector_io_header {
+
+    /**
+     * Byte order of the elements, VECTOR_IO_LITTLE_ENDIAN or VECTOR_IO_BIG_ENDIAN
+     */
+    int endianness;
+
+    /**
+     * Size of an element in Bytes
+     */
+    int type_size;
+
+    /**
+     * Number of elements
+     */
+    long long count;
+
+    /**
+     * Checksum of the bytes of the elements
+     */
+    uint64_t checksum;
+
+} vector_io_header;
+
+/**
+ * Running checksum: a Fletcher sum over the bytes, which can be updated one
+ * chunk at a time
+ */
+typedef struct vector_checksum {
+
+    /**
+     * Sum of the bytes
+     */
+    uint32_t sum;
+
+    /**
+     * Sum of the partial sums
+     */
+    uint32_t sum_of_sums;
+
+} vector_checksum;
+
+/**
+ * Adds size bytes to a checksum
+ */
+void vector_checksum_update(vector_checksum* c, const unsigned char* bytes, size_t size)
+{
+    uint32_t sum = c -> sum;
+    uint32_t sum_of_sums = c -> sum_of_sums;
+    size_t i;
+    for (i = 0; i < size; ++i)
+    {
+        sum += bytes[i];
+        sum_of_sums += sum;
+    }
+    c -> sum = sum;
+    c -> sum_of_sums = sum_of_sums;
+}
+
+/**
+ * Returns the value of a checksum
+ */
+uint64_t vector_checksum_value(const vector_checksum* c)
+{
+    return ((uint64_t) c -> sum_of_sums << 32) | c -> sum;
+}
+
+/**
+ * Returns the byte order of the machine
+ */
+int vector_io_endianness()
+{
+    const uint16_t probe = 1;
+    return *(const unsigned char*) &probe ? VECTOR_IO_LITTLE_ENDIAN : VECTOR_IO_BIG_ENDIAN;
+}
+
+/**
+ * Stores value in size bytes, least significant first
+ */
+void vector_io_put(unsigned char* bytes, uint64_t value, int size)
+{
+    int i;
+    for (i = 0; i < size; ++i)
+    {
+        bytes[i] = (unsigned char) (value >> (8 * i));
+    }
+}
+
+/**
+ * Loads a value from size bytes, least significant first
+ */
+uint64_t vector_io_get(const unsigned char* bytes, int size)
+{
+    uint64_t value = 0;
+    int i;
+    for (i = 0; i < size; ++i)
+    {
+        value |= (uint64_t) bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Writes a header
+ *
+ * @return status
+ */
+int vector_io_write_header(FILE* stream, const vector_io_header* h)
+{
+    unsigned char bytes[VECTOR_IO_HEADER_SIZE] = { 0 };
+    copy(bytes, VECTOR_IO_MAGIC, 4);
+    bytes[4] = VECTOR_IO_VERSION;
+    bytes[5] = (unsigned char) h -> endianness;
+    vector_io_put(bytes + 8, (uint64_t) h -> type_size, 4);
+    vector_io_put(bytes + 12, (uint64_t) h -> count, 8);
+    vector_io_put(bytes + 20, h -> checksum, 8);
+    return fwrite(bytes, 1, sizeof(bytes), stream) == sizeof(bytes) ? SUCCESS : FAILURE;
+}
+
+/**
+ * Reads and validates a header
+ *
+ * @return status
+ */
+int vector_io_read_header(FILE* stream, vector_io_header* h)
+{
+    unsigned char bytes[VECTOR_IO_HEADER_SIZE];
+    if (fread(bytes, 1, sizeof(bytes), stream) != sizeof(bytes) ||
+        compare(bytes, VECTOR_IO_MAGIC, 4) != 0 || bytes[4] != VECTOR_IO_VERSION)
+    {
+        return FAILURE;
+    }
+    h -> endianness = bytes[5];
+    h -> type_size = (int) vector_io_get(bytes + 8, 4);
+    h -> count = (long long) vector_io_get(bytes + 12, 8);
+    h -> checksum = vector_io_get(bytes + 20, 8);
+    if ((h -> endianness != VECTOR_IO_LITTLE_ENDIAN && h -> endianness != VECTOR_IO_BIG_ENDIAN) ||
+        h -> type_size <= 0 || h -> count < 0)
+    {
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/**
+ * Checks whether elements written with the given header have to be byte
+ * swapped on this machine
+ *
+ * @return true to swap, false not to, VALUE_ERROR when the elements can't
+ *         be converted because they are not 2, 4 or 8 bytes scalars
+ */
+int vector_io_needs_swap(const vector_io_header* h)
+{
+    if (h -> endianness == vector_io_endianness())
+    {
+        return false;
+    }
+    return h -> type_size == 2 || h -> type_size == 4 || h -> type_size == 8 ? true : VALUE_ERROR;
+}
+
+/**
+ * Reverses the bytes of count elements of type_size bytes
+ */
+void vector_io_swap_bytes(unsigned char* bytes, size_t count, int type_size)
+{
+    size_t i;
+    for (i = 0; i < count; ++i)
+    {
+        unsigned char* element = bytes + i * type_size;
+        int j;
+        for (j = 0; j < type_size / 2; ++j)
+        {
+            unsigned char byte = element[j];
+            element[j] = element[type_size - 1 - j];
+            element[type_size - 1 - j] = byte;
+        }
+    }
+}
+
+/**
+ * Writes a vector to a stream: a header with type size, count, byte order
+ * and checksum, followed by the packed elements. Packed vectors are written
+ * with a single call
+ *
+ * @param v pointer to the vector
+ * @param stream open for writing
+ * @return status
+ */
+int vector_save(vector* v, FILE* stream)
+{
+    int status = FAILURE;
+    if (!v || !stream || !v -> members.items)
+    {
+        return status;
+    }
+
+    int type_size = v -> get_type_size(v);
+    int item_size = v -> get_item_size(v);
+    int size = v -> size(v);
+    vector_checksum c = { 0, 0 };
+    int i;
+    if (item_size == type_size)
+    {
+        vector_checksum_update(&c, v -> members.items, (size_t) size * type_size);
+    }
+    else
+    {
+        for (i = 0; i < size; ++i)
+        {
+            vector_checksum_update(&c, item_address(v, i), type_size);
+        }
+    }
+
+    vector_io_header h = { vector_io_endianness(), type_size, size, vector_checksum_value(&c) };
+    if (vector_io_write_header(stream, &h) != SUCCESS)
+    {
+        return status;
+    }
+
+    if (item_size == type_size)
+    {
+        if (fwrite(v -> members.items, type_size, size, stream) != (size_t) size)
+        {
+            return status;
+        }
+    }
+    else
+    {
+        // Slot layout: elements are packed into a buffer a chunk at a time
+        int per_chunk = max(VECTOR_IO_CHUNK_BYTES / type_size, 1);
+        unsigned char* buffer = malloc((size_t) per_chunk * type_size);
+        if (!buffer)
+        {
+            return status;
+        }
+        int written = 0;
+        while (written < size)
+        {
+            int count = min(per_chunk, size - written);
+            for (i = 0; i < count; ++i)
+            {
+                copy(buffer + (size_t) i * type_size, item_address(v, written + i), type_size);
+            }
+            if (fwrite(buffer, type_size, count, stream) != (size_t) count)
+            {
+                break;
+            }
+            written += count;
+        }
+        free(buffer);
+        if (written < size)
+        {
+            return status;
+        }
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Streaming reader of a serialized vector, loading the elements a chunk at
+ * a time so that vectors bigger than memory can be processed
+ */
+typedef struct vector_reader {
+
+    /**
+     * Stream the elements come from
+     */
+    FILE* stream;
+
+    /**
+     * Header of the serialized vector
+     */
+    vector_io_header header;
+
+    /**
+     * Elements not read yet
+     */
+    long long remaining;
+
+    /**
+     * Whether the elements have to be byte swapped
+     */
+    int swap;
+
+    /**
+     * Checksum of the elements read so far
+     */
+    vector_checksum checksum;
+
+} vector_reader;
+
+/**
+ * Reads the header of a serialized vector
+ *
+ * @param r pointer to the reader
+ * @param stream open for reading, positioned at the header
+ * @return status
+ */
+int vector_reader_open(vector_reader* r, FILE* stream)
+{
+    int status = FAILURE;
+    if (!r || !stream || vector_io_read_header(stream, &r -> header) != SUCCESS)
+    {
+        return status;
+    }
+    r -> swap = vector_io_needs_swap(&r -> header);
+    if (r -> swap == VALUE_ERROR)
+    {
+        return status;
+    }
+    r -> stream = stream;
+    r -> remaining = r -> header.count;
+    r -> checksum.sum = 0;
+    r -> checksum.sum_of_sums = 0;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Returns the size of the serialized elements in Bytes
+ */
+int vector_reader_type_size(vector_reader* r)
+{
+    return r ? r -> header.type_size : VALUE_ERROR;
+}
+
+/**
+ * Returns the total number of serialized elements
+ */
+long long vector_reader_count(vector_reader* r)
+{
+    return r ? r -> header.count : VALUE_ERROR;
+}
+
+/**
+ * Replaces the content of chunk with the next elements. Once the last
+ * element is read the checksum is verified
+ *
+ * @param r pointer to the reader
+ * @param chunk vector with the type size of the serialized elements
+ * @param max_elements maximum number of elements to read
+ * @return number of elements read, 0 at the end, VALUE_ERROR on a read
+ *         error or a checksum mismatch
+ */
+int vector_reader_next(vector_reader* r, vector* chunk, int max_elements)
+{
+    if (!r || !chunk || max_elements <= 0 || chunk -> get_type_size(chunk) != r -> header.type_size)
+    {
+        return VALUE_ERROR;
+    }
+    if (r -> remaining == 0)
+    {
+        return 0;
+    }
+
+    int type_size = r -> header.type_size;
+    int count = (int) min((long long) max_elements, r -> remaining);
+    if (chunk -> resize(chunk, count) != SUCCESS)
+    {
+        return VALUE_ERROR;
+    }
+
+    if (chunk -> get_item_size(chunk) == type_size)
+    {
+        unsigned char* items = chunk -> members.items;
+        if (fread(items, type_size, count, r -> stream) != (size_t) count)
+        {
+            return VALUE_ERROR;
+        }
+        vector_checksum_update(&r -> checksum, items, (size_t) count * type_size);
+        if (r -> swap)
+        {
+            vector_io_swap_bytes(items, count, type_size);
+        }
+    }
+    else
+    {
+        int per_chunk = max(VECTOR_IO_CHUNK_BYTES / type_size, 1);
+        unsigned char* buffer = malloc((size_t) min(per_chunk, count) * type_size);
+        if (!buffer)
+        {
+            return VALUE_ERROR;
+        }
+        int read = 0;
+        while (read < count)
+        {
+            int n = min(per_chunk, count - read);
+            if (fread(buffer, type_size, n, r -> stream) != (size_t) n)
+            {
+                break;
+            }
+            vector_checksum_update(&r -> checksum, buffer, (size_t) n * type_size);
+            if (r -> swap)
+            {
+                vector_io_swap_bytes(buffer, n, type_size);
+            }
+            copy_items(chunk, read, buffer, n);
+            read += n;
+        }
+        free(buffer);
+        if (read < count)
+        {
+            return VALUE_ERROR;
+        }
+    }
+
+    r -> remaining -= count;
+    if (r -> remaining == 0 && vector_checksum_value(&r -> checksum) != r -> header.checksum)
+    {
+        return VALUE_ERROR;
+    }
+    return count;
+}
+
+/**
+ * Replaces the content of a vector with one read from a stream. Packed
+ * vectors are filled with a single read. On failure the vector is left empty
+ *
+ * @param v pointer to a vector with the type size of the serialized one
+ * @param stream open for reading, positioned at the header
+ * @return status
+ */
+int vector_load(vector* v, FILE* stream)
+{
+    int status = FAILURE;
+    if (!v)
+    {
+        return status;
+    }
+
+    vector_reader r;
+    if (vector_reader_open(&r, stream) == SUCCESS && r.header.count <= INT_MAX)
+    {
+        int count = (int) r.header.count;
+        if (count == 0)
+        {
+            int valid = v -> get_type_size(v) == r.header.type_size && r.header.checksum == 0;
+            status = valid ? v -> resize(v, 0) : FAILURE;
+        }
+        else if (vector_reader_next(&r, v, count) == count)
+        {
+            status = SUCCESS;
+        }
+    }
+    if (status != SUCCESS)
+    {
+        v -> resize(v, 0);
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file    vector_io_test.c - Main program for testing the vector serialization
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include "./vector_io.h"
+
+int main()
+{
+    vector v;
+    vector_init(&v, sizeof(int), 0, 0);
+    int i;
+    for (i = 0; i < 100000; ++i)
+    {
+        v.push_back(&v, &i);
+    }
+
+    FILE* stream = tmpfile();
+    int status = vector_save(&v, stream);
+    printf("Save 100000 ints:       (status %d)\n", status);
+
+    vector loaded;
+    vector_init_packed(&loaded, sizeof(int), 0, 0);
+    rewind(stream);
+    status = vector_load(&loaded, stream);
+    printf("Load:                   (status %d)\n", status);
+    printf("Size:                       %6d\n", loaded.size(&loaded));
+    printf("loaded[99999]:              %6d\n", *(int*) loaded.at(&loaded, 99999));
+
+    vector_reader r;
+    rewind(stream);
+    status = vector_reader_open(&r, stream);
+    printf("Reader open:            (status %d)\n", status);
+    printf("Reader count:               %6lld\n", vector_reader_count(&r));
+    vector chunk;
+    vector_init_packed(&chunk, sizeof(int), 0, 0);
+    int chunks = 0;
+    long long sum = 0;
+    int read;
+    while ((read = vector_reader_next(&r, &chunk, 30000)) > 0)
+    {
+        chunks++;
+        for (i = 0; i < read; ++i)
+        {
+            sum += *(int*) chunk.at(&chunk, i);
+        }
+    }
+    printf("Chunks read:                %6d\n", chunks);
+    printf("Sum matches:            (status %d)\n", read != 0 || sum != 100000LL * 99999 / 2);
+
+    // Flip one byte of the elements
+    fseek(stream, VECTOR_IO_HEADER_SIZE + 1000, SEEK_SET);
+    fputc(0xff, stream);
+    rewind(stream);
+    status = vector_load(&loaded, stream);
+    printf("Load corrupted:         (status %d)\n", status);
+    printf("Size:                       %6d\n", loaded.size(&loaded));
+
+    vector doubles;
+    vector_init(&doubles, sizeof(double), 0, 0);
+    double d = 1.5;
+    doubles.push_back(&doubles, &d);
+    rewind(stream);
+    printf("Load wrong type:        (status %d)\n", vector_load(&doubles, stream));
+    printf("Size:                       %6d\n", doubles.size(&doubles));
+
+    // Only part of the header, into a vector holding elements
+    unsigned char header[VECTOR_IO_HEADER_SIZE / 2];
+    rewind(stream);
+    FILE* truncated = tmpfile();
+    fwrite(header, 1, fread(header, 1, sizeof(header), stream), truncated);
+    rewind(truncated);
+    int values[] = { 1, 2, 3 };
+    loaded.assign_range(&loaded, values, 3);
+    printf("Size before:                %6d\n", loaded.size(&loaded));
+    printf("Load truncated header:  (status %d)\n", vector_load(&loaded, truncated));
+    printf("Size:                       %6d\n", loaded.size(&loaded));
+    fclose(truncated);
+
+    fclose(stream);
+    v.free(&v);
+    loaded.free(&loaded);
+    chunk.free(&chunk);
+    doubles.free(&doubles);
+    return 0;
+}
@@ -0,0 +1,441 @@
+/**
+ * @file    vector_soa.h - Columnar vector of records, one vector per field
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_SOA_H
+#define VECTOR_SOA_H
+
+#pragma once
+
+#include <stdint.h>
+#include "./vector.h"
+
+/**
+ * Struct-of-arrays vector: records made of several fields are split and
+ * every field is kept in its own packed vector, so that a scan over one
+ * field reads only the bytes of that field
+ */
+typedef struct vector_soa {
+
+    /**
+     * One packed vector per field
+     */
+    vector* columns;
+
+    /**
+     * Offset of every field inside a record passed to push_back and get
+     */
+    int* offsets;
+
+    /**
+     * Number of fields
+     */
+    int fields;
+
+    /**
+     * Number of records
+     */
+    int size;
+
+} vector_soa;
+
+/**
+ * Initializes an empty columnar vector drawing its memory from the given
+ * allocator
+ *
+ * @param s pointer to the columnar vector
+ * @param fields number of fields of a record
+ * @param sizes size of every field in Bytes
+ * @param offsets offset of every field inside a record, as given by
+ *                offsetof. NULL when the fields follow each other with no
+ *                padding
+ * @param alloc allocator, NULL for the heap
+ * @return status
+ */
+int vector_soa_init_allocator(vector_soa* s, int fields, const int* sizes, const int* offsets, const allocator* alloc)
+{
+    int status = FAILURE;
+    if (!s || fields <= 0 || !sizes)
+    {
+        return status;
+    }
+
+    s -> columns = malloc(sizeof(vector) * fields);
+    s -> offsets = malloc(sizeof(int) * fields);
+    if (!s -> columns || !s -> offsets)
+    {
+        free(s -> columns);
+        free(s -> offsets);
+        return status;
+    }
+
+    int offset = 0;
+    int i;
+    for (i = 0; i < fields; ++i)
+    {
+        vector_init_packed_allocator(&s -> columns[i], sizes[i], 0, 0, alloc);
+        s -> offsets[i] = offsets ? offsets[i] : offset;
+        offset += sizes[i];
+    }
+    s -> fields = fields;
+    s -> size = 0;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Initializes an empty columnar vector on the heap
+ *
+ * @param s pointer to the columnar vector
+ * @param fields number of fields of a record
+ * @param sizes size of every field in Bytes
+ * @param offsets offset of every field inside a record, NULL when packed
+ * @return status
+ */
+int vector_soa_init(vector_soa* s, int fields, const int* sizes, const int* offsets)
+{
+    return vector_soa_init_allocator(s, fields, sizes, offsets, NULL);
+}
+
+/**
+ * Returns the number of records
+ */
+int vector_soa_size(vector_soa* s)
+{
+    return s ? s -> size : VALUE_ERROR;
+}
+
+/**
+ * Returns the vector holding a field of every record
+ *
+ * @param s pointer to the columnar vector
+ * @param field index of the field
+ * @return column, NULL if the field doesn't exist
+ */
+vector* vector_soa_column(vector_soa* s, int field)
+{
+    if (!s || field < 0 || field >= s -> fields)
+    {
+        return NULL;
+    }
+    return &s -> columns[field];
+}
+
+/**
+ * Returns a field of a record
+ *
+ * @param s pointer to the columnar vector
+ * @param field index of the field
+ * @param index of the record
+ * @return pointer to the field, NULL out of bounds
+ */
+void* vector_soa_at(vector_soa* s, int field, int index)
+{
+    vector* column = vector_soa_column(s, field);
+    if (!column || index < 0 || index >= s -> size)
+    {
+        return NULL;
+    }
+    return item_address(column, index);
+}
+
+/**
+ * Makes room for at least the given number of records in every column
+ *
+ * @param s pointer to the columnar vector
+ * @param capacity number of records
+ * @return status
+ */
+int vector_soa_reserve(vector_soa* s, int capacity)
+{
+    int status = FAILURE;
+    if (s)
+    {
+        status = SUCCESS;
+        int i;
+        for (i = 0; i < s -> fields; ++i)
+        {
+            status |= s -> columns[i].reserve(&s -> columns[i], capacity);
+        }
+    }
+    return status;
+}
+
+/**
+ * Adds a record at the end, scattering its fields to the columns
+ *
+ * @param s pointer to the columnar vector
+ * @param record laid out as described by the offsets given at init
+ * @return status
+ */
+int vector_soa_push_back(vector_soa* s, const void* record)
+{
+    int status = FAILURE;
+    if (!s || !record)
+    {
+        return status;
+    }
+
+    int i;
+    for (i = 0; i < s -> fields; ++i)
+    {
+        vector* column = &s -> columns[i];
+        if (column -> push_back(column, (const unsigned char*) record + s -> offsets[i]) != SUCCESS)
+        {
+            // Columns must keep the same length
+            while (--i >= 0)
+            {
+                s -> columns[i].pop_back(&s -> columns[i]);
+            }
+            return status;
+        }
+    }
+    s -> size++;
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Gathers the fields of a record
+ *
+ * @param s pointer to the columnar vector
+ * @param index of the record
+ * @param record receiving the fields at the offsets given at init
+ * @return status
+ */
+int vector_soa_get(vector_soa* s, int index, void* record)
+{
+    int status = FAILURE;
+    if (!s || !record || index < 0 || index >= s -> size)
+    {
+        return status;
+    }
+    int i;
+    for (i = 0; i < s -> fields; ++i)
+    {
+        vector* column = &s -> columns[i];
+        copy((unsigned char*) record + s -> offsets[i], item_address(column, index), column -> get_type_size(column));
+    }
+    status = SUCCESS;
+    return status;
+}
+
+/**
+ * Deletes the record at the given index
+ *
+ * @param s pointer to the columnar vector
+ * @param index of the record
+ * @return status
+ */
+int vector_soa_erase_index(vector_soa* s, int index)
+{
+    int status = FAILURE;
+    if (!s || index < 0 || index >= s -> size)
+    {
+        return status;
+    }
+    status = SUCCESS;
+    int i;
+    for (i = 0; i < s -> fields; ++i)
+    {
+        status |= s -> columns[i].erase_index(&s -> columns[i], index);
+    }
+    s -> size--;
+    return status;
+}
+
+/**
+ * Counts the records whose field equals value, reading only that column.
+ * 4 and 8 bytes fields are compared as whole words in a loop the compiler
+ * can vectorize
+ *
+ * @param s pointer to the columnar vector
+ * @param field index of the field
+ * @param value to count
+ * @return number of matching records
+ */
+int vector_soa_count(vector_soa* s, int field, const void* value)
+{
+    vector* column = vector_soa_column(s, field);
+    if (!column || !value)
+    {
+        return VALUE_ERROR;
+    }
+
+    int size = s -> size;
+    int type_size = column -> get_type_size(column);
+    const unsigned char* items = column -> members.items;
+    int count = 0;
+    int i;
+    if (type_size == sizeof(uint32_t))
+    {
+        uint32_t needle = *(const kernel_half_word*) value;
+        for (i = 0; i < size; ++i)
+        {
+            count += *(const kernel_half_word*) (items + (size_t) i * sizeof(uint32_t)) == needle;
+        }
+    }
+    else if (type_size == sizeof(uint64_t))
+    {
+        uint64_t needle = *(const kernel_word*) value;
+        for (i = 0; i < size; ++i)
+        {
+            count += *(const kernel_word*) (items + (size_t) i * sizeof(uint64_t)) == needle;
+        }
+    }
+    else
+    {
+        for (i = 0; i < size; ++i)
+        {
+            count += compare(items + (size_t) i * type_size, value, type_size) == 0;
+        }
+    }
+    return count;
+}
+
+/**
+ * Appends to indices the index of every record whose field matches pred,
+ * reading only that column
+ *
+ * @param s pointer to the columnar vector
+ * @param field index of the field
+ * @param pred tells which fields match
+ * @param context passed to pred
+ * @param indices vector of int receiving the indices
+ * @return number of matching records
+ */
+int vector_soa_filter(vector_soa* s, int field, predicate pred, void* context, vector* indices)
+{
+    vector* column = vector_soa_column(s, field);
+    if (!column || !pred || !indices || indices -> get_type_size(indices) != sizeof(int))
+    {
+        return VALUE_ERROR;
+    }
+
+    int matches = 0;
+    int i;
+    for (i = 0; i < s -> size; ++i)
+    {
+        if (pred(item_address(column, i), context))
+        {
+            if (indices -> push_back(indices, &i) != SUCCESS)
+            {
+                return VALUE_ERROR;
+            }
+            matches++;
+        }
+    }
+    return matches;
+}
+
+/**
+ * Removes the records whose field matches pred, keeping the order of the
+ * others. The predicate reads only that column, every column is then
+ * compacted in a single pass
+ *
+ * @param s pointer to the columnar vector
+ * @param field index of the field
+ * @param pred tells which records to remove
+ * @param context passed to pred
+ * @return number of records removed
+ */
+int vector_soa_remove_if(vector_soa* s, int field, predicate pred, void* context)
+{
+    vector* column = vector_soa_column(s, field);
+    if (!column || !pred)
+    {
+        return VALUE_ERROR;
+    }
+
+    int size = s -> size;
+    unsigned char* removed = malloc(size > 0 ? size : 1);
+    if (!removed)
+    {
+        return VALUE_ERROR;
+    }
+    int i;
+    for (i = 0; i < size; ++i)
+    {
+        removed[i] = pred(item_address(column, i), context) != 0;
+    }
+
+    int kept = 0;
+    int f;
+    for (f = 0; f < s -> fields; ++f)
+    {
+        vector* c = &s -> columns[f];
+        int type_size = c -> get_type_size(c);
+        kept = 0;
+        for (i = 0; i < size; ++i)
+        {
+            if (!removed[i])
+            {
+                if (kept != i)
+                {
+                    copy(item_address(c, kept), item_address(c, i), type_size);
+                }
+                kept++;
+            }
+        }
+        c -> resize(c, kept);
+    }
+    free(removed);
+    s -> size = kept;
+    return size - kept;
+}
+
+/**
+ * Removes every record, keeping the capacity
+ *
+ * @param s pointer to the columnar vector
+ * @return status
+ */
+int vector_soa_clear(vector_soa* s)
+{
+    int status = FAILURE;
+    if (s)
+    {
+        status = SUCCESS;
+        int i;
+        for (i = 0; i < s -> fields; ++i)
+        {
+            status |= s -> columns[i].resize(&s -> columns[i], 0);
+        }
+        s -> size = 0;
+    }
+    return status;
+}
+
+/**
+ * Releases every column
+ *
+ * @param s pointer to the columnar vector
+ * @return status
+ */
+int vector_soa_free(vector_soa* s)
+{
+    int status = FAILURE;
+    if (s && s -> columns)
+    {
+        status = SUCCESS;
+        int i;
+        for (i = 0; i < s -> fields; ++i)
+        {
+            status |= s -> columns[i].free(&s -> columns[i]);
+        }
+        free(s -> columns);
+        free(s -> offsets);
+        s -> columns = NULL;
+        s -> offsets = NULL;
+        s -> fields = 0;
+        s -> size = 0;
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file    vector_soa_test.c - Main program for testing the columnar vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include "./vector_soa.h"
+
+typedef struct order {
+    long long id;
+    int customer;
+    double amount;
+    char status;
+} order;
+
+enum { ID, CUSTOMER, AMOUNT, STATUS };
+
+int above(const void* element, void* context)
+{
+    return *(const double*) element > *(const double*) context;
+}
+
+int main()
+{
+    int sizes[] = { sizeof(long long), sizeof(int), sizeof(double), sizeof(char) };
+    int offsets[] = { offsetof(order, id), offsetof(order, customer), offsetof(order, amount), offsetof(order, status) };
+    vector_soa s;
+    int status = vector_soa_init(&s, 4, sizes, offsets);
+    printf("Init 4 fields:          (status %d)\n", status);
+    printf("Reserve 1000:           (status %d)\n", vector_soa_reserve(&s, 1000));
+
+    int i;
+    for (i = 0; i < 1000; ++i)
+    {
+        order o = { 1000 + i, i % 7, i * 1.5, (char) ('a' + i % 3) };
+        status |= vector_soa_push_back(&s, &o);
+    }
+    printf("Push 1000 orders:       (status %d)\n", status);
+    printf("Size:                        %5d\n", vector_soa_size(&s));
+
+    int customer = 3;
+    printf("Orders of customer %d:       %5d\n", customer, vector_soa_count(&s, CUSTOMER, &customer));
+
+    double threshold = 1200.0;
+    vector indices;
+    vector_init_packed(&indices, sizeof(int), 0, 0);
+    printf("Amount > %.0f:              %5d\n", threshold, vector_soa_filter(&s, AMOUNT, above, &threshold, &indices));
+    printf("First match:                 %5d\n", *(int*) indices.at(&indices, 0));
+
+    order o;
+    status = vector_soa_get(&s, 42, &o);
+    printf("Get 42:                 (status %d)\n", status);
+    printf("Order 42:         %lld %d %.1f %c\n", o.id, o.customer, o.amount, o.status);
+
+    printf("Remove amount > %.0f:       %5d\n", threshold, vector_soa_remove_if(&s, AMOUNT, above, &threshold));
+    printf("Erase index 0:          (status %d)\n", vector_soa_erase_index(&s, 0));
+    printf("Size:                        %5d\n", vector_soa_size(&s));
+    printf("First id:                    %5lld\n", *(long long*) vector_soa_at(&s, ID, 0));
+    printf("Clear:                  (status %d)\n", vector_soa_clear(&s));
+    printf("Free:                   (status %d)\n", vector_soa_free(&s));
+    indices.free(&indices);
+
+    return 0;
+}
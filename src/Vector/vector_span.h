@@ -0,0 +1,158 @@
+/**
+ * @file    vector_span.h - Views over the elements of a vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_SPAN_H
+#define VECTOR_SPAN_H
+
+#pragma once
+
+#include <stddef.h>
+#include "./vector.h"
+
+/**
+ * View over count elements, stride bytes apart. Returned by value and
+ * iterated with plain pointer increments. A negative stride walks the
+ * elements backwards, so reversed views never point before the storage.
+ * A span is invalidated by anything reallocating the vector it views
+ */
+typedef struct vector_span {
+
+    /**
+     * First element of the view
+     */
+    unsigned char* data;
+
+    /**
+     * Number of elements
+     */
+    int count;
+
+    /**
+     * Distance in bytes from an element to the next one of the view
+     */
+    ptrdiff_t stride;
+
+} vector_span;
+
+/**
+ * Returns a view over count elements of a vector from first, empty when
+ * the range is out of bounds
+ *
+ * @param v pointer to the vector
+ * @param first index of the first element
+ * @param count number of elements
+ * @return view
+ */
+vector_span vector_span_range(vector* v, int first, int count)
+{
+    vector_span s = { NULL, 0, 0 };
+    if (v && first >= 0 && count >= 0 && first <= v -> size(v) - count)
+    {
+        s.data = item_address(v, first);
+        s.count = count;
+        s.stride = v -> get_item_size(v);
+    }
+    return s;
+}
+
+/**
+ * Returns a view over every element of a vector
+ */
+vector_span vector_span_of(vector* v)
+{
+    return vector_span_range(v, 0, v ? v -> size(v) : 0);
+}
+
+/**
+ * Returns the number of elements of a view
+ */
+int vector_span_size(vector_span s)
+{
+    return s.count;
+}
+
+/**
+ * Checks whether a view has no elements
+ */
+int vector_span_empty(vector_span s)
+{
+    return s.count == 0;
+}
+
+/**
+ * Returns the i-th element of a view, NULL out of bounds
+ */
+void* vector_span_at(vector_span s, int index)
+{
+    if (index < 0 || index >= s.count)
+    {
+        return NULL;
+    }
+    return s.data + index * s.stride;
+}
+
+/**
+ * Returns the view over count elements of a view from first, empty when
+ * the range is out of bounds
+ *
+ * @param s view
+ * @param first index of the first element, inside the view
+ * @param count number of elements
+ * @return sub-view
+ */
+vector_span vector_span_slice(vector_span s, int first, int count)
+{
+    vector_span slice = { NULL, 0, s.stride };
+    if (first >= 0 && count >= 0 && first <= s.count - count && count > 0)
+    {
+        slice.data = s.data + first * s.stride;
+        slice.count = count;
+    }
+    return slice;
+}
+
+/**
+ * Returns the same elements in reverse order
+ */
+vector_span vector_span_reverse(vector_span s)
+{
+    vector_span reversed = { s.data, s.count, -s.stride };
+    if (s.count > 0)
+    {
+        reversed.data = s.data + (s.count - 1) * s.stride;
+    }
+    return reversed;
+}
+
+/**
+ * Iterates over a view, it pointing to every element as a T*. The loop
+ * never forms a pointer outside the elements but one past the last of a
+ * forward view, break and continue work as in any loop. Views of packed
+ * elements, whose stride is sizeof(T), step with it + 1: the compiler
+ * splits the loop on the stride and can vectorize the packed one
+ */
+#define VECTOR_SPAN_FOR_EACH(T, it, span)                                               \
+    for (vector_span it##_span = (span); it##_span.count > 0; it##_span.count = 0)      \
+        for (T* it = (T*) it##_span.data; it##_span.count > 0;                          \
+             it = it##_span.stride == (ptrdiff_t) sizeof(T) ? it + 1                    \
+                  : it##_span.count > 1 ? (T*) ((unsigned char*) it + it##_span.stride) \
+                  : it,                                                                 \
+             it##_span.count--)
+
+/**
+ * Iterates over every element of a vector, first to last
+ */
+#define VECTOR_FOR_EACH(T, it, v) VECTOR_SPAN_FOR_EACH(T, it, vector_span_of(v))
+
+/**
+ * Iterates over every element of a vector, last to first
+ */
+#define VECTOR_FOR_EACH_REVERSE(T, it, v) VECTOR_SPAN_FOR_EACH(T, it, vector_span_reverse(vector_span_of(v)))
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file    vector_span_test.c - Main program for testing the vector views
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./vector_span.h"
+
+int main()
+{
+    vector v;
+    vector_init(&v, sizeof(int), 0, 0);
+    int i;
+    for (i = 0; i < 10; ++i)
+    {
+        v.push_back(&v, &i);
+    }
+
+    vector_span s = vector_span_of(&v);
+    printf("Span size:                   %5d\n", vector_span_size(s));
+    printf("Stride:                      %5d\n", (int) s.stride);
+
+    printf("\n");
+    VECTOR_FOR_EACH(int, it, &v)
+    {
+        printf("%d ", *it);
+    }
+    printf("\n");
+    VECTOR_FOR_EACH_REVERSE(int, it, &v)
+    {
+        printf("%d ", *it);
+    }
+    printf("\n");
+
+    vector_span slice = vector_span_slice(s, 2, 5);
+    VECTOR_SPAN_FOR_EACH(int, it, slice)
+    {
+        if (*it == 5)
+        {
+            continue;
+        }
+        printf("%d ", *it);
+    }
+    printf("\n");
+    VECTOR_SPAN_FOR_EACH(int, it, vector_span_reverse(slice))
+    {
+        if (*it == 3)
+        {
+            break;
+        }
+        printf("%d ", *it);
+    }
+    printf("\n\n");
+
+    printf("Slice at 0:                  %5d\n", *(int*) vector_span_at(slice, 0));
+    printf("Slice at out of bounds: (null %d)\n", vector_span_at(slice, 5) == NULL);
+    printf("Slice out of bounds:    (empty %d)\n", vector_span_empty(vector_span_slice(s, 8, 5)));
+
+    // Packed elements summed over a unit stride loop
+    vector p;
+    vector_init_packed(&p, sizeof(long long), 0, 0);
+    long long value;
+    for (value = 1; value <= 1000; ++value)
+    {
+        p.push_back(&p, &value);
+    }
+    long long sum = 0;
+    VECTOR_FOR_EACH(long long, it, &p)
+    {
+        sum += *it;
+    }
+    printf("Sum of 1..1000:             %6lld\n", sum);
+
+    // Padded elements take the strided path of the same loop
+    int padded_sum = 0;
+    VECTOR_FOR_EACH(int, it, &v)
+    {
+        padded_sum += *it;
+    }
+    printf("Sum of padded 0..9:          %5d\n", padded_sum);
+
+    vector_span empty = vector_span_range(&p, 0, 0);
+    int visited = 0;
+    VECTOR_SPAN_FOR_EACH(long long, it, empty)
+    {
+        visited++;
+    }
+    printf("Empty span visits:           %5d\n", visited);
+
+    v.free(&v);
+    p.free(&p);
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file    vector_stats.h - Opt-in instrumentation of the vector operations
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_STATS_H
+#define VECTOR_STATS_H
+
+#pragma once
+
+/**
+ * Operations whose calls and latency are recorded
+ */
+enum vector_op {
+    VECTOR_OP_PUSH_BACK,
+    VECTOR_OP_INSERT,
+    VECTOR_OP_ERASE,
+    VECTOR_OP_FIND,
+    VECTOR_OP_SORT,
+    VECTOR_OP_GROW,
+    VECTOR_OPS
+};
+
+/**
+ * Latency histogram buckets: bucket i counts the calls taking between 2^i
+ * and 2^(i+1) nanoseconds
+ */
+#define VECTOR_STATS_BUCKETS 32
+
+#ifdef VECTOR_STATS
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * Counters of a vector, also summed over all the vectors
+ */
+typedef struct vector_stats {
+
+    /**
+     * Calls of every operation
+     */
+    long long calls[VECTOR_OPS];
+
+    /**
+     * Nanoseconds spent in every operation
+     */
+    long long nanoseconds[VECTOR_OPS];
+
+    /**
+     * Bytes copied or moved by the vector: new elements, elements shifted by
+     * insertions and erasures, elements carried over to a new storage
+     */
+    long long bytes_copied;
+
+    /**
+     * Elements shifted by insertions and erasures
+     */
+    long long elements_shifted;
+
+    /**
+     * Storage reallocations
+     */
+    long long reallocations;
+
+    /**
+     * Largest size reached
+     */
+    long long peak_size;
+
+    /**
+     * Largest capacity reached
+     */
+    long long peak_capacity;
+
+} vector_stats;
+
+/**
+ * Counters summed over all the vectors. Not synchronized, like the vectors
+ */
+vector_stats vector_stats_global;
+
+/**
+ * Latency histogram of every operation over all the vectors
+ */
+long long vector_stats_histogram[VECTOR_OPS][VECTOR_STATS_BUCKETS];
+
+const char* vector_op_names[VECTOR_OPS] = { "push_back", "insert", "erase", "find", "sort", "grow" };
+
+/**
+ * Returns a monotonic timestamp in nanoseconds
+ */
+long long vector_stats_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Records a call of an operation started at the given timestamp
+ */
+void vector_stats_record(vector_stats* s, int op, long long start)
+{
+    long long elapsed = vector_stats_now() - start;
+    int bucket = 0;
+    while (bucket < VECTOR_STATS_BUCKETS - 1 && (elapsed >> (bucket + 1)) > 0)
+    {
+        bucket++;
+    }
+    s -> calls[op]++;
+    s -> nanoseconds[op] += elapsed;
+    vector_stats_global.calls[op]++;
+    vector_stats_global.nanoseconds[op] += elapsed;
+    vector_stats_histogram[op][bucket]++;
+}
+
+/**
+ * Adds amount to the counter at the given offset of both the vector and the
+ * global counters
+ */
+void vector_stats_add(vector_stats* s, size_t offset, long long amount)
+{
+    *(long long*) ((unsigned char*) s + offset) += amount;
+    *(long long*) ((unsigned char*) &vector_stats_global + offset) += amount;
+}
+
+/**
+ * Updates the peaks of size and capacity
+ */
+void vector_stats_peak(vector_stats* s, long long size, long long capacity)
+{
+    s -> peak_size = s -> peak_size > size ? s -> peak_size : size;
+    s -> peak_capacity = s -> peak_capacity > capacity ? s -> peak_capacity : capacity;
+    if (vector_stats_global.peak_size < size)
+    {
+        vector_stats_global.peak_size = size;
+    }
+    if (vector_stats_global.peak_capacity < capacity)
+    {
+        vector_stats_global.peak_capacity = capacity;
+    }
+}
+
+/**
+ * Prints counters, and the latency histograms when they are the global ones
+ *
+ * @param stream to print to
+ * @param s counters of a vector, NULL for the global ones
+ */
+void vector_stats_dump(FILE* stream, const vector_stats* s)
+{
+    int global = !s;
+    if (global)
+    {
+        s = &vector_stats_global;
+    }
+    fprintf(stream, "%s vector stats\n", global ? "global" : "local");
+    fprintf(stream, "  reallocations     %lld\n", s -> reallocations);
+    fprintf(stream, "  bytes copied      %lld\n", s -> bytes_copied);
+    fprintf(stream, "  elements shifted  %lld\n", s -> elements_shifted);
+    fprintf(stream, "  peak size         %lld\n", s -> peak_size);
+    fprintf(stream, "  peak capacity     %lld\n", s -> peak_capacity);
+    int op;
+    for (op = 0; op < VECTOR_OPS; ++op)
+    {
+        if (s -> calls[op] == 0)
+        {
+            continue;
+        }
+        fprintf(stream, "  %-10s calls %lld, mean %.1f ns\n", vector_op_names[op], s -> calls[op],
+                (double) s -> nanoseconds[op] / s -> calls[op]);
+        int bucket;
+        for (bucket = 0; global && bucket < VECTOR_STATS_BUCKETS; ++bucket)
+        {
+            if (vector_stats_histogram[op][bucket] > 0)
+            {
+                fprintf(stream, "    < %11lld ns  %lld\n", 2LL << bucket, vector_stats_histogram[op][bucket]);
+            }
+        }
+    }
+}
+
+/**
+ * Resets the global counters and histograms
+ */
+void vector_stats_reset()
+{
+    vector_stats empty = { 0 };
+    vector_stats_global = empty;
+    int op;
+    int bucket;
+    for (op = 0; op < VECTOR_OPS; ++op)
+    {
+        for (bucket = 0; bucket < VECTOR_STATS_BUCKETS; ++bucket)
+        {
+            vector_stats_histogram[op][bucket] = 0;
+        }
+    }
+}
+
+#define VECTOR_STATS_START(start) long long start = vector_stats_now()
+#define VECTOR_STATS_STOP(v, op, start) vector_stats_record(&(v) -> members.stats, op, start)
+#define VECTOR_STATS_ADD(v, counter, amount) \
+    vector_stats_add(&(v) -> members.stats, offsetof(vector_stats, counter), amount)
+#define VECTOR_STATS_PEAK(v) vector_stats_peak(&(v) -> members.stats, (v) -> members.size, (v) -> members.capacity)
+
+#else
+
+// Without VECTOR_STATS every hook compiles to nothing
+#define VECTOR_STATS_START(start) ((void) 0)
+#define VECTOR_STATS_STOP(v, op, start) ((void) 0)
+#define VECTOR_STATS_ADD(v, counter, amount) ((void) 0)
+#define VECTOR_STATS_PEAK(v) ((void) 0)
+
+#endif
+
+#endif
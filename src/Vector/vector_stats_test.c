@@ -0,0 +1,51 @@
+/**
+ * @file    vector_stats_test.c - Main program for testing the vector instrumentation
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#define VECTOR_STATS
+#include <stdio.h>
+#include "./vector.h"
+
+int main()
+{
+    vector grown;
+    vector_init(&grown, sizeof(int), 0, 0);
+    int i;
+    for (i = 0; i < 100000; ++i)
+    {
+        grown.push_back(&grown, &i);
+    }
+    for (i = 0; i < 100; ++i)
+    {
+        grown.insert(&grown, &i, 0);
+        grown.erase_index(&grown, grown.size(&grown) / 2);
+    }
+    i = 99999;
+    printf("Find %d:                %6d\n", i, grown.find(&grown, &i));
+    printf("Sort:                   (status %d)\n", grown.sort(&grown, compare_int));
+
+    vector reserved;
+    vector_init(&reserved, sizeof(int), 0, 0);
+    reserved.reserve(&reserved, 100000);
+    for (i = 0; i < 100000; ++i)
+    {
+        reserved.push_back(&reserved, &i);
+    }
+
+    printf("\n");
+    vector_stats_dump(stdout, &grown.members.stats);
+    printf("\n");
+    vector_stats_dump(stdout, &reserved.members.stats);
+    printf("\n");
+    vector_stats_dump(stdout, NULL);
+
+    grown.free(&grown);
+    reserved.free(&reserved);
+    vector_stats_reset();
+    return 0;
+}
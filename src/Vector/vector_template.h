@@ -0,0 +1,359 @@
+/**
+ * @file    vector_template.h - Type-specialized dynamic array in C
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef VECTOR_TEMPLATE_H
+#define VECTOR_TEMPLATE_H
+
+#pragma once
+
+#include <limits.h>
+#include <stdlib.h>
+#include "../utils.h"
+
+#define VECTOR_TEMPLATE_INIT_CAPACITY 1
+
+/**
+ * Returns the capacity to grow to in order to hold needed elements: twice
+ * as many, clamped to INT_MAX
+ */
+static inline int vector_template_grown_capacity(int needed)
+{
+    long long capacity = (long long) needed * 2 + VECTOR_TEMPLATE_INIT_CAPACITY;
+    return (int) min(capacity, (long long) INT_MAX);
+}
+
+/**
+ * Default equality used by the generated find and count
+ */
+#define VECTOR_DEFAULT_EQUALS(a, b) ((a) == (b))
+
+/**
+ * Declares a vector of T named vector_T. See VECTOR_DECLARE_FULL
+ *
+ * @param T type of data stored, must be a single identifier (use a typedef
+ *          or VECTOR_DECLARE_NAMED for types such as unsigned int)
+ */
+#define VECTOR_DECLARE(T) VECTOR_DECLARE_FULL(T, T, VECTOR_DEFAULT_EQUALS)
+
+/**
+ * Declares a vector of T named vector_name. See VECTOR_DECLARE_FULL
+ *
+ * @param name suffix of the generated type and functions
+ * @param T type of data stored
+ */
+#define VECTOR_DECLARE_NAMED(name, T) VECTOR_DECLARE_FULL(name, T, VECTOR_DEFAULT_EQUALS)
+
+/**
+ * Declares the type vector_name, holding elements of type T in a plain T
+ * array, together with its static inline operations. Unlike the type-erased
+ * vector, nothing goes through function pointers: elements are compared
+ * with EQUALS and copied with plain assignments, so the compiler can inline
+ * and vectorize the loops.
+ *
+ * Generated operations (prefix vector_name_):
+ *   init, free, size, capacity, empty, begin, end, at, front, back,
+ *   reserve, resize, shrink, push_back, pop_back, insert, erase_index,
+ *   assign, fill, find, count, clear
+ *
+ * They follow the conventions of vector.h: functions returning a status
+ * return SUCCESS or FAILURE, lookups return VALUE_ERROR when nothing is
+ * found, accessors return NULL on invalid indexes and clear zeroes the
+ * elements without changing size and capacity.
+ *
+ * @param name suffix of the generated type and functions
+ * @param T type of data stored
+ * @param EQUALS function-like macro EQUALS(a, b) comparing two values of T
+ */
+#define VECTOR_DECLARE_FULL(name, T, EQUALS)                                    \
+                                                                                \
+typedef struct vector_##name {                                                  \
+    int size;                                                                   \
+    int capacity;                                                               \
+    T* items;                                                                   \
+} vector_##name;                                                                \
+                                                                                \
+static inline int vector_##name##_reserve(vector_##name* v, int new_capacity)   \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && new_capacity >= 0)                                                 \
+    {                                                                           \
+        status = SUCCESS;                                                       \
+        if (new_capacity > v -> capacity)                                       \
+        {                                                                       \
+            T* temp = realloc(v -> items, (size_t) new_capacity * sizeof(T));   \
+            if (temp)                                                           \
+            {                                                                   \
+                v -> items = temp;                                              \
+                v -> capacity = new_capacity;                                   \
+            }                                                                   \
+            else                                                                \
+            {                                                                   \
+                status = FAILURE;                                               \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_init(vector_##name* v, int initialCapacity)   \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v)                                                                      \
+    {                                                                           \
+        v -> size = 0;                                                          \
+        v -> capacity = 0;                                                      \
+        v -> items = NULL;                                                      \
+        if (initialCapacity <= 0)                                               \
+        {                                                                       \
+            initialCapacity = VECTOR_TEMPLATE_INIT_CAPACITY;                    \
+        }                                                                       \
+        status = vector_##name##_reserve(v, initialCapacity);                   \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_free(vector_##name* v)                        \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v)                                                                      \
+    {                                                                           \
+        free(v -> items);                                                       \
+        v -> items = NULL;                                                      \
+        v -> size = 0;                                                          \
+        v -> capacity = 0;                                                      \
+        status = SUCCESS;                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_size(const vector_##name* v)                  \
+{                                                                               \
+    return v ? v -> size : VALUE_ERROR;                                         \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_capacity(const vector_##name* v)              \
+{                                                                               \
+    return v ? v -> capacity : VALUE_ERROR;                                     \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_empty(const vector_##name* v)                 \
+{                                                                               \
+    return v ? v -> size == 0 : false;                                          \
+}                                                                               \
+                                                                                \
+static inline T* vector_##name##_begin(vector_##name* v)                        \
+{                                                                               \
+    return v ? v -> items : NULL;                                               \
+}                                                                               \
+                                                                                \
+static inline T* vector_##name##_end(vector_##name* v)                          \
+{                                                                               \
+    return v ? v -> items + v -> size : NULL;                                   \
+}                                                                               \
+                                                                                \
+static inline T* vector_##name##_at(vector_##name* v, int index)                \
+{                                                                               \
+    T* value = NULL;                                                            \
+    if (v && index >= 0 && index < v -> size)                                   \
+    {                                                                           \
+        value = &v -> items[index];                                             \
+    }                                                                           \
+    return value;                                                               \
+}                                                                               \
+                                                                                \
+static inline T* vector_##name##_front(vector_##name* v)                        \
+{                                                                               \
+    return vector_##name##_at(v, 0);                                            \
+}                                                                               \
+                                                                                \
+static inline T* vector_##name##_back(vector_##name* v)                         \
+{                                                                               \
+    return v ? vector_##name##_at(v, v -> size - 1) : NULL;                     \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_resize(vector_##name* v, int new_size)        \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && new_size >= 0)                                                     \
+    {                                                                           \
+        status = SUCCESS;                                                       \
+        if (new_size > v -> capacity)                                           \
+        {                                                                       \
+            status = vector_##name##_reserve(v,                                 \
+                         vector_template_grown_capacity(new_size));             \
+        }                                                                       \
+        if (status == SUCCESS)                                                  \
+        {                                                                       \
+            v -> size = new_size;                                               \
+        }                                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_shrink(vector_##name* v)                      \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && v -> size > 0)                                                     \
+    {                                                                           \
+        T* temp = realloc(v -> items, (size_t) v -> size * sizeof(T));         \
+        if (temp)                                                               \
+        {                                                                       \
+            v -> items = temp;                                                  \
+            v -> capacity = v -> size;                                          \
+            status = SUCCESS;                                                   \
+        }                                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_push_back(vector_##name* v, T value)          \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && v -> size < INT_MAX)                                               \
+    {                                                                           \
+        status = SUCCESS;                                                       \
+        if (v -> size == v -> capacity)                                         \
+        {                                                                       \
+            status = vector_##name##_reserve(v,                                 \
+                         vector_template_grown_capacity(v -> size));            \
+        }                                                                       \
+        if (status == SUCCESS)                                                  \
+        {                                                                       \
+            v -> items[v -> size++] = value;                                    \
+        }                                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline T* vector_##name##_pop_back(vector_##name* v)                     \
+{                                                                               \
+    T* item = NULL;                                                             \
+    if (v && v -> size > 0)                                                     \
+    {                                                                           \
+        item = &v -> items[--v -> size];                                        \
+    }                                                                           \
+    return item;                                                                \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_insert(vector_##name* v, T value, int pos)    \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && pos >= 0 && pos <= v -> size)                                      \
+    {                                                                           \
+        int size = v -> size;                                                   \
+        status = vector_##name##_resize(v, size + 1);                           \
+        if (status == SUCCESS)                                                  \
+        {                                                                       \
+            T* items = v -> items;                                              \
+            int i;                                                              \
+            for (i = size; i > pos; --i)                                        \
+            {                                                                   \
+                items[i] = items[i - 1];                                        \
+            }                                                                   \
+            items[pos] = value;                                                 \
+        }                                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_erase_index(vector_##name* v, int index)      \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && index >= 0 && index < v -> size)                                  \
+    {                                                                           \
+        T* items = v -> items;                                                  \
+        int size = v -> size - 1;                                               \
+        int i;                                                                  \
+        for (i = index; i < size; ++i)                                          \
+        {                                                                       \
+            items[i] = items[i + 1];                                            \
+        }                                                                       \
+        v -> size = size;                                                       \
+        status = SUCCESS;                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_assign(vector_##name* v, T value, int index)  \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && index >= 0 && index < v -> size)                                   \
+    {                                                                           \
+        v -> items[index] = value;                                              \
+        status = SUCCESS;                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_fill(vector_##name* v, T value)               \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v)                                                                      \
+    {                                                                           \
+        T* items = v -> items;                                                  \
+        int size = v -> size;                                                   \
+        int i;                                                                  \
+        for (i = 0; i < size; ++i)                                              \
+        {                                                                       \
+            items[i] = value;                                                   \
+        }                                                                       \
+        status = SUCCESS;                                                       \
+    }                                                                           \
+    return status;                                                              \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_find(const vector_##name* v, T value)         \
+{                                                                               \
+    int index = VALUE_ERROR;                                                    \
+    if (v)                                                                      \
+    {                                                                           \
+        const T* items = v -> items;                                            \
+        int size = v -> size;                                                   \
+        int i;                                                                  \
+        for (i = 0; i < size; ++i)                                              \
+        {                                                                       \
+            if (EQUALS(items[i], value))                                        \
+            {                                                                   \
+                index = i;                                                      \
+                break;                                                          \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    return index;                                                               \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_count(const vector_##name* v, T value)        \
+{                                                                               \
+    int count = VALUE_ERROR;                                                    \
+    if (v)                                                                      \
+    {                                                                           \
+        const T* items = v -> items;                                            \
+        int size = v -> size;                                                   \
+        int i;                                                                  \
+        count = 0;                                                              \
+        for (i = 0; i < size; ++i)                                              \
+        {                                                                       \
+            count += (EQUALS(items[i], value)) != 0;                            \
+        }                                                                       \
+    }                                                                           \
+    return count;                                                               \
+}                                                                               \
+                                                                                \
+static inline int vector_##name##_clear(vector_##name* v)                       \
+{                                                                               \
+    int status = FAILURE;                                                       \
+    if (v && v -> items)                                                        \
+    {                                                                           \
+        int value = 0;                                                          \
+        status = set(v -> items, v -> items + v -> size, &value, sizeof(value)); \
+    }                                                                           \
+    return status;                                                              \
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file    vector_template_test.c - Main program for testing the type-specialized vector
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#include <stdio.h>
+#include "./vector_template.h"
+
+VECTOR_DECLARE(int)
+VECTOR_DECLARE(double)
+
+void print_vector(vector_int* v)
+{
+    int i;
+    int size = vector_int_size(v);
+    for (i = 0; i < size; ++i)
+    {
+        printf("v[%d] = %d\n", i, *vector_int_at(v, i));
+    }
+}
+
+int main()
+{
+    vector_int v;
+    vector_int_init(&v, 5);
+
+    printf("Initial size:                %5d\n", vector_int_size(&v));
+    printf("Initial capacity:            %5d\n", vector_int_capacity(&v));
+    printf("Empty:                  (status %d)\n", vector_int_empty(&v));
+
+    int i;
+    int status;
+    printf("\n");
+    for (i = 3; i <= 6; ++i)
+    {
+        status = vector_int_push_back(&v, i);
+        printf("Push Back %d:            (status %d)\n", i, status);
+    }
+    printf("\n");
+
+    // Operations
+    printf("Pop Back:                    %5d\n", *vector_int_pop_back(&v));
+
+    status = vector_int_insert(&v, 104, 0);
+    printf("Insert %d:             (status %d)\n", 104, status);
+
+    status = vector_int_insert(&v, 4, vector_int_size(&v));
+    printf("Insert %d at the end:    (status %d)\n", 4, status);
+
+    printf("Find %d Index:                %5d\n", 4, vector_int_find(&v, 4));
+    printf("Count value %d:               %5d\n", 4, vector_int_count(&v, 4));
+
+    status = vector_int_erase_index(&v, 2);
+    printf("Erase Index %d:          (status %d)\n", 2, status);
+
+    status = vector_int_assign(&v, 42, vector_int_size(&v) - 1);
+    printf("Assign %d:              (status %d)\n", 42, status);
+
+    printf("Front:                       %5d\n", *vector_int_front(&v));
+    printf("Back:                        %5d\n", *vector_int_back(&v));
+    printf("Shrink:                 (status %d)\n", vector_int_shrink(&v));
+    printf("Current size:                %5d\n", vector_int_size(&v));
+    printf("Current capacity:            %5d\n", vector_int_capacity(&v));
+
+    printf("\n");
+    print_vector(&v);
+    printf("\n");
+
+    status = vector_int_fill(&v, 68);
+    printf("Fill %d:                (status %d)\n", 68, status);
+
+    printf("Clear:                  (status %d)\n", vector_int_clear(&v));
+    print_vector(&v);
+
+    vector_int_free(&v);
+
+    vector_double d;
+    vector_double_init(&d, 0);
+    for (i = 0; i < 4; ++i)
+    {
+        vector_double_push_back(&d, i * 0.5);
+    }
+    printf("\nFind %f Index:         %5d\n", 1.0, vector_double_find(&d, 1.0));
+    vector_double_free(&d);
+
+    return 0;
+}
@@ -10,9 +10,32 @@
 #include <stdio.h>
 #include "./vector.h"
 
-int custom_compare(const void* a, const void* b, int size)
+int equals_int(const void* element, void* context)
 {
-    return (compare(a, b, size) == 0);
+    return *(const int*) element == *(const int*) context;
+}
+
+typedef struct pair {
+    int key;
+    int order;
+} pair;
+
+int compare_pair_key(const void* a, const void* b)
+{
+    return compare_int(&((const pair*) a) -> key, &((const pair*) b) -> key);
+}
+
+int sorted_by(vector* v, int first, int last, comparator cmp)
+{
+    int i;
+    for (i = first + 1; i < last; ++i)
+    {
+        if (cmp(v -> at(v, i - 1), v -> at(v, i)) > 0)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 int main()
@@ -87,8 +110,16 @@ int main()
     printf("\n");
 
     i = 3;
-    status = v.remove_if(&v, 0, v.size(&v), &i, sizeof(int), custom_compare);
-    printf("Remove If v[i] == 0:    (status %d)\n", status);
+    status = v.remove_if(&v, 0, v.size(&v), equals_int, &i);
+    printf("Remove If v[i] == 3:    (status %d)\n", status);
+
+    i = 73;
+    status = v.remove_if_unordered(&v, 0, v.size(&v), equals_int, &i);
+    printf("Remove If Unordered %d: (status %d)\n", i, status);
+
+    i = 42;
+    status = v.erase_if(&v, equals_int, &i);
+    printf("Erase If %d:            (status %d)\n", i, status);
 
     printf("\n");
     for (i = 0; i < v.size(&v); ++i)
@@ -133,6 +164,202 @@ int main()
 
     printf("Clear:                  (status %d)\n", v.clear(&v));
 
+    int values[] = { 42, 7, 19, 7, -3, 88, 0 };
+    status = v.assign_range(&v, values, sizeof(values) / sizeof(values[0]));
+    printf("Assign range:           (status %d)\n", status);
+
+    status = v.sort(&v, compare_int);
+    printf("Sort:                   (status %d)\n", status);
+
+    printf("\n");
+    for (i = 0; i < v.size(&v); ++i)
+    {
+        printf("v[%d] = %d\n", i, *(int*) v.at(&v, i));
+    }
+    printf("\n");
+
+    i = 7;
+    printf("Lower bound %d:               %5d\n", i, v.lower_bound(&v, &i, compare_int));
+    printf("Upper bound %d:               %5d\n", i, v.upper_bound(&v, &i, compare_int));
+    printf("Binary search %d:       (status %d)\n", i, v.binary_search(&v, &i, compare_int));
+    i = 8;
+    printf("Binary search %d:       (status %d)\n", i, v.binary_search(&v, &i, compare_int));
+
+    vector w;
+    vector_init_packed(&w, sizeof(int), 0, 0);
+    int* buffer = malloc(sizeof(int) * 100);
+    for (i = 0; i < 100; ++i)
+    {
+        buffer[i] = i;
+    }
+    status = vector_adopt(&w, buffer, 100, 100);
+    printf("Adopt 100 elements:     (status %d)\n", status);
+    printf("Same storage:           (status %d)\n", w.begin(&w) != buffer);
+    printf("Adopt own storage:      (status %d)\n", vector_adopt(&w, w.begin(&w), 100, 100));
+    printf("w[99] after:                 %5d\n", *(int*) w.at(&w, 99));
+
+    status = vector_swap(&v, &w);
+    printf("Swap:                   (status %d)\n", status);
+    printf("Sizes:                  %5d %5d\n", v.size(&v), w.size(&w));
+    printf("w[0] inline:                 %5d\n", *(int*) w.at(&w, 0));
+
+    status = vector_move(&w, &v);
+    printf("Move:                   (status %d)\n", status);
+    printf("Sizes:                  %5d %5d\n", v.size(&v), w.size(&w));
+
+    int count;
+    int capacity;
+    buffer = vector_release(&w, &count, &capacity);
+    printf("Release:                (status %d)\n", buffer == NULL);
+    printf("Count and capacity:     %5d %5d\n", count, capacity);
+    printf("buffer[99]:                  %5d\n", buffer[99]);
+    printf("Empty after release:         %5d\n", w.empty(&w));
+    free(buffer);
+    w.free(&w);
+
+    // Growth policy
+    vector g;
+    vector_init_packed(&g, sizeof(int), 0, 0);
+    printf("\n");
+    printf("Growth 1.0:             (status %d)\n", g.set_growth(&g, 1.0, 16));
+    printf("Growth min chunk 0:     (status %d)\n", g.set_growth(&g, 2.0, 0));
+    status = g.set_growth(&g, 2.0, 16);
+    printf("Growth 2.0, chunk 16:   (status %d)\n", status);
+    for (i = 0; i < 1000; ++i)
+    {
+        status |= g.push_back(&g, &i);
+    }
+    printf("Push back 1000:         (status %d)\n", status);
+    printf("Capacity:                    %5d\n", g.capacity(&g));
+    printf("Reallocations:               %5d\n", g.get_reallocations(&g));
+
+    status = g.resize(&g, 0);
+    status |= g.shrink(&g);
+    status |= g.set_growth(&g, 1.5, 400);
+    printf("Growth 1.5, chunk 400:  (status %d)\n", status);
+    for (i = 0; i < 1000; ++i)
+    {
+        status |= g.push_back(&g, &i);
+    }
+    printf("Push back 1000:         (status %d)\n", status);
+    printf("Capacity:                    %5d\n", g.capacity(&g));
+    printf("Reallocations:               %5d\n", g.get_reallocations(&g));
+    g.free(&g);
+
+    // Ranges
+    vector r;
+    vector_init(&r, sizeof(int), 0, 0);
+    int head[] = { 0, 1, 2, 7, 8 };
+    int middle[] = { 3, 4, 5, 6 };
+    int tail[] = { 9, 10 };
+    printf("\n");
+    status = r.append(&r, head, 5);
+    printf("Append 5:               (status %d)\n", status);
+    status = r.insert_range(&r, 3, middle, 4);
+    printf("Insert range at 3:      (status %d)\n", status);
+    status = r.append(&r, tail, 2);
+    printf("Append 2:               (status %d)\n", status);
+    status = r.insert_range(&r, r.size(&r), tail, 0);
+    printf("Insert empty range:     (status %d)\n", status);
+    printf("Insert past the end:    (status %d)\n", r.insert_range(&r, r.size(&r) + 1, tail, 1));
+    printf("Insert negative count:  (status %d)\n", r.insert_range(&r, 0, tail, -1));
+
+    printf("\n");
+    for (i = 0; i < r.size(&r); ++i)
+    {
+        printf("%d ", *(int*) r.at(&r, i));
+    }
+    printf("\n\n");
+
+    status = r.erase_range(&r, 2, 6);
+    printf("Erase range [2, 6):     (status %d)\n", status);
+    status = r.erase_range(&r, 4, 4);
+    printf("Erase empty range:      (status %d)\n", status);
+    printf("Erase reversed range:   (status %d)\n", r.erase_range(&r, 4, 3));
+    printf("Erase past the end:     (status %d)\n", r.erase_range(&r, 0, r.size(&r) + 1));
+    status = r.erase_range(&r, r.size(&r) - 2, r.size(&r));
+    printf("Erase last two:         (status %d)\n", status);
+
+    printf("\n");
+    for (i = 0; i < r.size(&r); ++i)
+    {
+        printf("%d ", *(int*) r.at(&r, i));
+    }
+    printf("\n");
+    r.free(&r);
+
+    // Sorting algorithms
+    vector u;
+    vector_init_packed(&u, sizeof(unsigned), 0, 0);
+    unsigned seed = 12345;
+    for (i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        u.push_back(&u, &seed);
+    }
+    printf("\n");
+    status = u.sort(&u, compare_unsigned);
+    printf("Radix sort unsigned:    (status %d)\n", status | !sorted_by(&u, 0, u.size(&u), compare_unsigned));
+    u.free(&u);
+
+    vector l;
+    vector_init_packed(&l, sizeof(long long), 0, 0);
+    for (i = 0; i < 1000; ++i)
+    {
+        long long value = (long long) ((i * 7919) % 1000 - 500) * 1000000007LL;
+        l.push_back(&l, &value);
+    }
+    status = l.sort(&l, compare_long_long);
+    printf("Radix sort long long:   (status %d)\n", status | !sorted_by(&l, 0, l.size(&l), compare_long_long));
+    printf("Front and back:  %lld %lld\n", *(long long*) l.front(&l), *(long long*) l.back(&l));
+    l.free(&l);
+
+    vector n;
+    vector_init_packed(&n, sizeof(int), 0, 0);
+    for (i = 0; i < 1000; ++i)
+    {
+        int value = (i * 7919) % 1000;
+        n.push_back(&n, &value);
+    }
+    status = n.nth_element(&n, 500, compare_int);
+    int nth = *(int*) n.at(&n, 500);
+    for (i = 0; i < n.size(&n); ++i)
+    {
+        int value = *(int*) n.at(&n, i);
+        status |= i < 500 ? value > nth : value < nth;
+    }
+    printf("Nth element 500:        (status %d)\n", status);
+    printf("Element 500:                 %5d\n", nth);
+    printf("Nth past the end:       (status %d)\n", n.nth_element(&n, n.size(&n), compare_int));
+
+    status = n.partial_sort(&n, 10, compare_int);
+    status |= !sorted_by(&n, 0, 10, compare_int);
+    for (i = 0; i < 10; ++i)
+    {
+        status |= *(int*) n.at(&n, i) != i;
+    }
+    printf("Partial sort 10:        (status %d)\n", status);
+    printf("Partial sort past size: (status %d)\n", n.partial_sort(&n, n.size(&n) + 1, compare_int));
+    n.free(&n);
+
+    vector p;
+    vector_init(&p, sizeof(pair), 0, 0);
+    for (i = 0; i < 1000; ++i)
+    {
+        pair item = { (i * 7919) % 10, i };
+        p.push_back(&p, &item);
+    }
+    status = p.stable_sort(&p, compare_pair_key);
+    status |= !sorted_by(&p, 0, p.size(&p), compare_pair_key);
+    for (i = 1; i < p.size(&p); ++i)
+    {
+        pair* previous = p.at(&p, i - 1);
+        pair* current = p.at(&p, i);
+        status |= previous -> key == current -> key && previous -> order > current -> order;
+    }
+    printf("Stable sort by key:     (status %d)\n", status);
+    p.free(&p);
+
     v.free(&v);
 
     return 0;
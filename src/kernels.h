@@ -0,0 +1,264 @@
+/**
+ * @file    kernels.h - Bulk memory kernels used by the utilities
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNELS_X86
+#endif
+
+/**
+ * Machine word which can be loaded from and stored to any address
+ */
+typedef uint64_t __attribute__((__may_alias__, __aligned__(1))) kernel_word;
+
+/**
+ * Half of a machine word which can be loaded from and stored to any address
+ */
+typedef uint32_t __attribute__((__may_alias__, __aligned__(1))) kernel_half_word;
+
+/**
+ * Set of kernels selected at runtime for the running CPU
+ */
+typedef struct kernel_table {
+
+    /**
+     * Copies size bytes going from the first to the last one. Safe for
+     * overlapping ranges when dst is before src
+     */
+    void (*forward)(unsigned char* dst, const unsigned char* src, size_t size);
+
+    /**
+     * Copies size bytes going from the last to the first one. Safe for
+     * overlapping ranges when dst is after src
+     */
+    void (*backward)(unsigned char* dst, const unsigned char* src, size_t size);
+
+    /**
+     * Checks whether the first size bytes of the two buffers are equal
+     */
+    int (*equal)(const unsigned char* a, const unsigned char* b, size_t size);
+
+} kernel_table;
+
+/**
+ * Copies size bytes forward, one word at a time
+ *
+ * @param dst  pointer to destination
+ * @param src  pointer to source
+ * @param size number of bytes to copy
+ */
+void kernel_forward_word(unsigned char* dst, const unsigned char* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + sizeof(kernel_word) <= size; i += sizeof(kernel_word))
+    {
+        *(kernel_word*) (dst + i) = *(const kernel_word*) (src + i);
+    }
+    for (; i < size; ++i)
+    {
+        dst[i] = src[i];
+    }
+}
+
+/**
+ * Copies size bytes backward, one word at a time
+ *
+ * @param dst  pointer to destination
+ * @param src  pointer to source
+ * @param size number of bytes to copy
+ */
+void kernel_backward_word(unsigned char* dst, const unsigned char* src, size_t size)
+{
+    size_t i = size;
+    for (; i >= sizeof(kernel_word); i -= sizeof(kernel_word))
+    {
+        *(kernel_word*) (dst + i - sizeof(kernel_word)) = *(const kernel_word*) (src + i - sizeof(kernel_word));
+    }
+    while (i > 0)
+    {
+        i--;
+        dst[i] = src[i];
+    }
+}
+
+/**
+ * Compares size bytes, one word at a time
+ *
+ * @param a    first buffer
+ * @param b    second buffer
+ * @param size number of bytes to compare
+ * @return whether the buffers are equal
+ */
+int kernel_equal_word(const unsigned char* a, const unsigned char* b, size_t size)
+{
+    size_t i = 0;
+    for (; i + sizeof(kernel_word) <= size; i += sizeof(kernel_word))
+    {
+        if (*(const kernel_word*) (a + i) != *(const kernel_word*) (b + i))
+        {
+            return 0;
+        }
+    }
+    for (; i < size; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#ifdef KERNELS_X86
+
+/**
+ * Copies size bytes forward, 16 bytes at a time
+ */
+__attribute__((target("sse2")))
+void kernel_forward_sse2(unsigned char* dst, const unsigned char* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) (src + i));
+        _mm_storeu_si128((__m128i*) (dst + i), chunk);
+    }
+    kernel_forward_word(dst + i, src + i, size - i);
+}
+
+/**
+ * Copies size bytes backward, 16 bytes at a time
+ */
+__attribute__((target("sse2")))
+void kernel_backward_sse2(unsigned char* dst, const unsigned char* src, size_t size)
+{
+    size_t i = size;
+    for (; i >= 16; i -= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*) (src + i - 16));
+        _mm_storeu_si128((__m128i*) (dst + i - 16), chunk);
+    }
+    kernel_backward_word(dst, src, i);
+}
+
+/**
+ * Compares size bytes, 16 bytes at a time
+ */
+__attribute__((target("sse2")))
+int kernel_equal_sse2(const unsigned char* a, const unsigned char* b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i chunk_a = _mm_loadu_si128((const __m128i*) (a + i));
+        __m128i chunk_b = _mm_loadu_si128((const __m128i*) (b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b)) != 0xFFFF)
+        {
+            return 0;
+        }
+    }
+    return kernel_equal_word(a + i, b + i, size - i);
+}
+
+/**
+ * Copies size bytes forward, 32 bytes at a time
+ */
+__attribute__((target("avx2")))
+void kernel_forward_avx2(unsigned char* dst, const unsigned char* src, size_t size)
+{
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*) (src + i));
+        _mm256_storeu_si256((__m256i*) (dst + i), chunk);
+    }
+    kernel_forward_word(dst + i, src + i, size - i);
+}
+
+/**
+ * Copies size bytes backward, 32 bytes at a time
+ */
+__attribute__((target("avx2")))
+void kernel_backward_avx2(unsigned char* dst, const unsigned char* src, size_t size)
+{
+    size_t i = size;
+    for (; i >= 32; i -= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*) (src + i - 32));
+        _mm256_storeu_si256((__m256i*) (dst + i - 32), chunk);
+    }
+    kernel_backward_word(dst, src, i);
+}
+
+/**
+ * Compares size bytes, 32 bytes at a time
+ */
+__attribute__((target("avx2")))
+int kernel_equal_avx2(const unsigned char* a, const unsigned char* b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i chunk_a = _mm256_loadu_si256((const __m256i*) (a + i));
+        __m256i chunk_b = _mm256_loadu_si256((const __m256i*) (b + i));
+        if ((unsigned) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk_a, chunk_b)) != 0xFFFFFFFFu)
+        {
+            return 0;
+        }
+    }
+    return kernel_equal_word(a + i, b + i, size - i);
+}
+
+#endif
+
+/**
+ * Returns the kernels for the running CPU, selecting them on the first call
+ * (AVX2, then SSE2, then the portable word-at-a-time fallback). The tables
+ * are constant and the selected one is published with a single atomic
+ * store, so threads racing on the first call all agree on the same table
+ *
+ * @return table of kernels
+ */
+const kernel_table* kernels()
+{
+    static const kernel_table word_table = { kernel_forward_word, kernel_backward_word, kernel_equal_word };
+#ifdef KERNELS_X86
+    static const kernel_table sse2_table = { kernel_forward_sse2, kernel_backward_sse2, kernel_equal_sse2 };
+    static const kernel_table avx2_table = { kernel_forward_avx2, kernel_backward_avx2, kernel_equal_avx2 };
+#endif
+    static const kernel_table* selected = NULL;
+    const kernel_table* table = __atomic_load_n(&selected, __ATOMIC_ACQUIRE);
+    if (!table)
+    {
+        table = &word_table;
+#ifdef KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            table = &avx2_table;
+        }
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            table = &sse2_table;
+        }
+#endif
+        __atomic_store_n(&selected, table, __ATOMIC_RELEASE);
+    }
+    return table;
+}
+
+#endif
@@ -0,0 +1,558 @@
+/**
+ * @file    sort.h - Sorting and searching over arrays of fixed-size elements
+ * @author  Vincenzo Cardea (vincenzo.cardea.05@gmail.com)
+ * @version 0.4
+ * @date    2024-04-11
+ *
+ * @copyright Copyright (c) 2023
+ */
+
+#ifndef SORT_H
+#define SORT_H
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "utils.h"
+
+#define SORT_INSERTION_THRESHOLD 16
+#define SORT_RADIX_THRESHOLD 256
+#define SORT_RADIX_BUCKETS 256
+
+/**
+ * Orders two elements: negative if a comes before b, zero if they are
+ * equivalent, positive if a comes after b
+ */
+typedef int (*comparator)(const void* a, const void* b);
+
+/**
+ * Orders two int
+ */
+int compare_int(const void* a, const void* b)
+{
+    int x = *(const int*) a;
+    int y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Orders two unsigned int
+ */
+int compare_unsigned(const void* a, const void* b)
+{
+    unsigned x = *(const unsigned*) a;
+    unsigned y = *(const unsigned*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Orders two long long
+ */
+int compare_long_long(const void* a, const void* b)
+{
+    long long x = *(const long long*) a;
+    long long y = *(const long long*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Orders two unsigned long long
+ */
+int compare_unsigned_long_long(const void* a, const void* b)
+{
+    unsigned long long x = *(const unsigned long long*) a;
+    unsigned long long y = *(const unsigned long long*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Orders two float
+ */
+int compare_float(const void* a, const void* b)
+{
+    float x = *(const float*) a;
+    float y = *(const float*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Orders two double
+ */
+int compare_double(const void* a, const void* b)
+{
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Sorts n elements with insertion sort. Stable
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ */
+void insertion_sort(unsigned char* base, size_t n, size_t size, comparator cmp)
+{
+    size_t i;
+    for (i = 1; i < n; ++i)
+    {
+        size_t j = i;
+        while (j > 0 && cmp(base + (j - 1) * size, base + j * size) > 0)
+        {
+            swap(base + (j - 1) * size, base + j * size, size);
+            j--;
+        }
+    }
+}
+
+/**
+ * Moves the element at index root down the max-heap of n elements
+ */
+void sift_down(unsigned char* base, size_t root, size_t n, size_t size, comparator cmp)
+{
+    size_t child;
+    while ((child = 2 * root + 1) < n)
+    {
+        if (child + 1 < n && cmp(base + child * size, base + (child + 1) * size) < 0)
+        {
+            child++;
+        }
+        if (cmp(base + root * size, base + child * size) >= 0)
+        {
+            return;
+        }
+        swap(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+/**
+ * Turns n elements into a max-heap
+ */
+void make_heap(unsigned char* base, size_t n, size_t size, comparator cmp)
+{
+    size_t i = n / 2;
+    while (i > 0)
+    {
+        i--;
+        sift_down(base, i, n, size, cmp);
+    }
+}
+
+/**
+ * Sorts n elements with heap sort
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ */
+void heap_sort(unsigned char* base, size_t n, size_t size, comparator cmp)
+{
+    make_heap(base, n, size, cmp);
+    while (n > 1)
+    {
+        n--;
+        swap(base, base + n * size, size);
+        sift_down(base, 0, n, size, cmp);
+    }
+}
+
+/**
+ * Partitions n elements around the median of the first, middle and last
+ * one. Elements before the returned index don't come after the pivot,
+ * elements after it don't come before it
+ *
+ * @return final index of the pivot
+ */
+size_t partition(unsigned char* base, size_t n, size_t size, comparator cmp)
+{
+    unsigned char* first = base;
+    unsigned char* middle = base + (n / 2) * size;
+    unsigned char* last = base + (n - 1) * size;
+    if (cmp(middle, first) < 0) swap(middle, first, size);
+    if (cmp(last, middle) < 0) swap(last, middle, size);
+    if (cmp(middle, first) < 0) swap(middle, first, size);
+    swap(first, middle, size);
+
+    size_t i = 0;
+    size_t j = n;
+    while (true)
+    {
+        do { i++; } while (i < n && cmp(base + i * size, base) < 0);
+        do { j--; } while (cmp(base + j * size, base) > 0);
+        if (i >= j)
+        {
+            break;
+        }
+        swap(base + i * size, base + j * size, size);
+    }
+    swap(base, base + j * size, size);
+    return j;
+}
+
+/**
+ * Sorts n elements with introsort: quicksort falling back to heap sort when
+ * the recursion gets too deep and to insertion sort on short ranges
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ * @param depth remaining recursion depth
+ */
+void introsort(unsigned char* base, size_t n, size_t size, comparator cmp, int depth)
+{
+    while (n > SORT_INSERTION_THRESHOLD)
+    {
+        if (depth == 0)
+        {
+            heap_sort(base, n, size, cmp);
+            return;
+        }
+        depth--;
+
+        size_t pivot = partition(base, n, size, cmp);
+        size_t right = n - pivot - 1;
+        if (pivot < right)
+        {
+            introsort(base, pivot, size, cmp, depth);
+            base += (pivot + 1) * size;
+            n = right;
+        }
+        else
+        {
+            introsort(base + (pivot + 1) * size, right, size, cmp, depth);
+            n = pivot;
+        }
+    }
+    insertion_sort(base, n, size, cmp);
+}
+
+/**
+ * Recursion depth allowed to introsort before switching to heap sort
+ */
+int introsort_depth(size_t n)
+{
+    int depth = 0;
+    while (n > 1)
+    {
+        n >>= 1;
+        depth++;
+    }
+    return 2 * depth;
+}
+
+/**
+ * Sorts n elements
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ */
+void quick_sort(unsigned char* base, size_t n, size_t size, comparator cmp)
+{
+    introsort(base, n, size, cmp, introsort_depth(n));
+}
+
+/**
+ * Merges two sorted runs into dst. Stable: on ties the element of the left
+ * run comes first
+ *
+ * @param dst buffer of (n_left + n_right) * size bytes
+ * @param left first sorted run
+ * @param n_left number of elements in the left run
+ * @param right second sorted run
+ * @param n_right number of elements in the right run
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ */
+void merge(unsigned char* dst, const unsigned char* left, size_t n_left,
+           const unsigned char* right, size_t n_right, size_t size, comparator cmp)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+    while (i < n_left && j < n_right)
+    {
+        if (cmp(right + j * size, left + i * size) < 0)
+        {
+            copy(dst + k++ * size, right + j++ * size, size);
+        }
+        else
+        {
+            copy(dst + k++ * size, left + i++ * size, size);
+        }
+    }
+    if (i < n_left)
+    {
+        copy(dst + k * size, left + i * size, (n_left - i) * size);
+    }
+    if (j < n_right)
+    {
+        copy(dst + k * size, right + j * size, (n_right - j) * size);
+    }
+}
+
+/**
+ * Sorts n elements with a bottom-up merge sort. Stable
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ * @param scratch buffer of n * size bytes
+ */
+void merge_sort(unsigned char* base, size_t n, size_t size, comparator cmp, unsigned char* scratch)
+{
+    size_t run;
+    for (run = 0; run < n; run += SORT_INSERTION_THRESHOLD)
+    {
+        insertion_sort(base + run * size, min((size_t) SORT_INSERTION_THRESHOLD, n - run), size, cmp);
+    }
+
+    unsigned char* src = base;
+    unsigned char* dst = scratch;
+    size_t width;
+    for (width = SORT_INSERTION_THRESHOLD; width < n; width *= 2)
+    {
+        size_t left;
+        for (left = 0; left < n; left += 2 * width)
+        {
+            size_t middle = min(left + width, n);
+            size_t right = min(left + 2 * width, n);
+            merge(dst + left * size, src + left * size, middle - left,
+                  src + middle * size, right - middle, size, cmp);
+        }
+        unsigned char* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != base)
+    {
+        copy(base, src, n * size);
+    }
+}
+
+/**
+ * Sorts n integer keys of key_size (4 or 8) bytes with an LSD radix sort,
+ * one byte per pass. Passes where every key has the same byte are skipped.
+ * Stable
+ *
+ * @param base pointer to the first key
+ * @param n number of keys
+ * @param key_size size of a key in bytes
+ * @param is_signed whether keys are two's complement signed integers
+ * @param scratch buffer of n * key_size bytes
+ */
+void radix_sort(unsigned char* base, size_t n, size_t key_size, int is_signed, unsigned char* scratch)
+{
+    uint64_t sign = is_signed ? (uint64_t) 1 << (8 * key_size - 1) : 0;
+    unsigned char* src = base;
+    unsigned char* dst = scratch;
+    size_t pass;
+    for (pass = 0; pass < key_size; ++pass)
+    {
+        size_t counts[SORT_RADIX_BUCKETS] = { 0 };
+        int shift = 8 * (int) pass;
+        size_t i;
+        for (i = 0; i < n; ++i)
+        {
+            uint64_t key = key_size == 4 ? *(const kernel_half_word*) (src + i * 4)
+                                         : *(const kernel_word*) (src + i * 8);
+            counts[((key ^ sign) >> shift) & 0xFF]++;
+        }
+
+        size_t total = 0;
+        int skip = false;
+        int b;
+        for (b = 0; b < SORT_RADIX_BUCKETS; ++b)
+        {
+            size_t count = counts[b];
+            skip |= (count == n);
+            counts[b] = total;
+            total += count;
+        }
+        if (skip)
+        {
+            continue;
+        }
+
+        for (i = 0; i < n; ++i)
+        {
+            uint64_t key = key_size == 4 ? *(const kernel_half_word*) (src + i * 4)
+                                         : *(const kernel_word*) (src + i * 8);
+            size_t position = counts[((key ^ sign) >> shift) & 0xFF]++;
+            copy(dst + position * key_size, src + i * key_size, key_size);
+        }
+        unsigned char* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != base)
+    {
+        copy(base, src, n * key_size);
+    }
+}
+
+/**
+ * Checks whether elements ordered by cmp can be sorted by radix_sort
+ *
+ * @param size size of an element in bytes
+ * @param cmp comparator
+ * @param is_signed set to whether the keys are signed
+ * @return if radix sort applies
+ */
+int radix_sortable(size_t size, comparator cmp, int* is_signed)
+{
+    int sortable = false;
+    if (size == sizeof(int) && (cmp == compare_int || cmp == compare_unsigned))
+    {
+        sortable = true;
+        *is_signed = (cmp == compare_int);
+    }
+    else if (size == sizeof(long long) && (cmp == compare_long_long || cmp == compare_unsigned_long_long))
+    {
+        sortable = true;
+        *is_signed = (cmp == compare_long_long);
+    }
+    return sortable;
+}
+
+/**
+ * Rearranges n elements so that the first k are the smallest ones, sorted
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param k number of smallest elements to sort
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ */
+void partial_sort(unsigned char* base, size_t n, size_t k, size_t size, comparator cmp)
+{
+    if (k == 0)
+    {
+        return;
+    }
+
+    make_heap(base, k, size, cmp);
+    size_t i;
+    for (i = k; i < n; ++i)
+    {
+        if (cmp(base + i * size, base) < 0)
+        {
+            swap(base + i * size, base, size);
+            sift_down(base, 0, k, size, cmp);
+        }
+    }
+    heap_sort(base, k, size, cmp);
+}
+
+/**
+ * Rearranges n elements so that the nth one is the one which would be there
+ * if they were sorted, with no element before it coming after it and no
+ * element after it coming before it
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param nth index of the element to place
+ * @param size distance in bytes between two consecutive elements
+ * @param cmp comparator
+ */
+void nth_element(unsigned char* base, size_t n, size_t nth, size_t size, comparator cmp)
+{
+    int depth = introsort_depth(n);
+    while (n > SORT_INSERTION_THRESHOLD)
+    {
+        if (depth-- == 0)
+        {
+            heap_sort(base, n, size, cmp);
+            return;
+        }
+
+        size_t pivot = partition(base, n, size, cmp);
+        if (pivot == nth)
+        {
+            return;
+        }
+        if (nth < pivot)
+        {
+            n = pivot;
+        }
+        else
+        {
+            base += (pivot + 1) * size;
+            n -= pivot + 1;
+            nth -= pivot + 1;
+        }
+    }
+    insertion_sort(base, n, size, cmp);
+}
+
+/**
+ * Returns the index of the first element not coming before value, in n
+ * elements sorted by cmp
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param value to look for
+ * @param cmp comparator
+ * @return index between 0 and n
+ */
+size_t lower_bound(const unsigned char* base, size_t n, size_t size, const void* value, comparator cmp)
+{
+    size_t first = 0;
+    while (n > 0)
+    {
+        size_t half = n / 2;
+        if (cmp(base + (first + half) * size, value) < 0)
+        {
+            first += half + 1;
+            n -= half + 1;
+        }
+        else
+        {
+            n = half;
+        }
+    }
+    return first;
+}
+
+/**
+ * Returns the index of the first element coming after value, in n elements
+ * sorted by cmp
+ *
+ * @param base pointer to the first element
+ * @param n number of elements
+ * @param size distance in bytes between two consecutive elements
+ * @param value to look for
+ * @param cmp comparator
+ * @return index between 0 and n
+ */
+size_t upper_bound(const unsigned char* base, size_t n, size_t size, const void* value, comparator cmp)
+{
+    size_t first = 0;
+    while (n > 0)
+    {
+        size_t half = n / 2;
+        if (cmp(base + (first + half) * size, value) <= 0)
+        {
+            first += half + 1;
+            n -= half + 1;
+        }
+        else
+        {
+            n = half;
+        }
+    }
+    return first;
+}
+
+#endif
@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <stddef.h>
+#include "kernels.h"
+
 #define min(a,b) ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a < _b ? _a : _b; })
+#define max(a,b) ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a > _b ? _a : _b; })
 
 /**
  * Functions exit codes
@@ -44,21 +48,25 @@ int compare(const void* a, const void* b, int size)
     int status = FAILURE;
     if (a && b && size > 0)
     {
-        status = SUCCESS;
-        const unsigned char* bytes_a = (const unsigned char*) a;
-        const unsigned char* bytes_b = (const unsigned char*) b;
-        int i = 0;
-        while (i < size && !status)
+        if (size == sizeof(kernel_half_word))
         {
-            status = (bytes_a[i] != bytes_b[i]);
-            i++;
+            status = (*(const kernel_half_word*) a != *(const kernel_half_word*) b);
+        }
+        else if (size == sizeof(kernel_word))
+        {
+            status = (*(const kernel_word*) a != *(const kernel_word*) b);
+        }
+        else
+        {
+            status = !kernels() -> equal(a, b, size);
         }
     }
     return status;
 }
 
 /**
- * Copies N bytes of memory from src to dst
+ * Copies N bytes of memory from src to dst. The two buffers must not
+ * overlap, otherwise use move
  *
  * @param dst  pointer to destination
  * @param src  pointer to source
@@ -70,13 +78,43 @@ int copy(const void* dst, const void* src, size_t size)
     int status = FAILURE;
     if (dst && src && size > 0)
     {
-        unsigned char* bytes_dst = (unsigned char*) dst;
-        unsigned char* bytes_src = (unsigned char*) src;
+        if (size == sizeof(kernel_half_word))
+        {
+            *(kernel_half_word*) dst = *(const kernel_half_word*) src;
+        }
+        else if (size == sizeof(kernel_word))
+        {
+            *(kernel_word*) dst = *(const kernel_word*) src;
+        }
+        else
+        {
+            kernels() -> forward((unsigned char*) dst, src, size);
+        }
+        status = SUCCESS;
+    }
+    return status;
+}
 
-        int i;
-        for (i = 0; i < size; ++i)
+/**
+ * Copies N bytes of memory from src to dst, even if the buffers overlap
+ *
+ * @param dst  pointer to destination
+ * @param src  pointer to source
+ * @param size number of bytes to copy
+ * @return status
+ */
+int move(const void* dst, const void* src, size_t size)
+{
+    int status = FAILURE;
+    if (dst && src && size > 0)
+    {
+        if (dst < src)
+        {
+            kernels() -> forward((unsigned char*) dst, src, size);
+        }
+        else if (dst > src)
         {
-            bytes_dst[i] = bytes_src[i];
+            kernels() -> backward((unsigned char*) dst, src, size);
         }
         status = SUCCESS;
     }
@@ -90,20 +128,46 @@ int copy(const void* dst, const void* src, size_t size)
  * @param end pointer after the last byte
  * @param value value to copy
  * @param value_size size of the value
- * @return status - number of copies which went wrong
+ * @return status
  */
 int set(const void* start, const void* end, const void* value, size_t value_size)
 {
     int status = FAILURE;
-    if (start && end && value)
+    if (start && end && value && value_size > 0 && start <= end)
     {
         status = SUCCESS;
-        long long bytes = end - start;
-        size_t i;
-        for (i = 0; i < bytes; i += value_size)
+        unsigned char* bytes = (unsigned char*) start;
+        size_t length = (const unsigned char*) end - bytes;
+        size_t filled = 0;
+        if (value_size == 1 || value_size == sizeof(kernel_half_word) || value_size == sizeof(kernel_word))
         {
-            value_size = min(value_size, bytes - i);
-            status += copy(start + i, value, value_size);
+            // The value repeated over a whole word, stored one word at a time
+            kernel_word pattern;
+            size_t i;
+            for (i = 0; i < sizeof(pattern); i += value_size)
+            {
+                copy((unsigned char*) &pattern + i, value, value_size);
+            }
+            for (; filled + sizeof(pattern) <= length; filled += sizeof(pattern))
+            {
+                *(kernel_word*) (bytes + filled) = pattern;
+            }
+            for (i = 0; filled < length; ++i, ++filled)
+            {
+                bytes[filled] = ((unsigned char*) &pattern)[i];
+            }
+        }
+        else if (length > 0)
+        {
+            // Writes the value once, then keeps doubling the filled prefix
+            filled = min(value_size, length);
+            copy(bytes, value, filled);
+            while (filled < length)
+            {
+                size_t chunk = min(filled, length - filled);
+                copy(bytes + filled, bytes, chunk);
+                filled += chunk;
+            }
         }
     }
     return status;
@@ -123,10 +187,17 @@ int swap(void* a, void* b, int size)
     if (a && b && size > 0)
     {
         status = SUCCESS;
-        void* temp;
-        status += copy(temp, a, size);
-        status += copy(a, b, size);
-        status += copy(b, temp, size);
+        unsigned char temp[64];
+        unsigned char* bytes_a = (unsigned char*) a;
+        unsigned char* bytes_b = (unsigned char*) b;
+        int i;
+        for (i = 0; i < size; i += (int) sizeof(temp))
+        {
+            int chunk = min(size - i, (int) sizeof(temp));
+            status |= copy(temp, bytes_a + i, chunk);
+            status |= copy(bytes_a + i, bytes_b + i, chunk);
+            status |= copy(bytes_b + i, temp, chunk);
+        }
     }
     return status;
 }